@@ -13,9 +13,30 @@
 
 #include "part2.h"
 
+#define SIZE_CLASSES (sizeof(size_t) * 8) // One segregated free list per power of two a size can have
+
+/**
+ * Links stored in the memory of a free node that chain it into the free list of its size class.
+ */
+typedef struct _FreeLinks
+{
+    Node *nextFree;
+    Node *prevFree;
+}FreeLinks;
+
+#define FREE_LINKS(node) ((FreeLinks *)((void *)(node) + sizeof(Node)))
+
 Node *firstBlock; // Initialise pointer to first node of list
 Node *lastUsed; // Initialise pointer that points to last accessed node (specific to nextFit)
 
+/* Algorithms that index their free nodes set these so that splitting and coalescing keep the index up to date */
+static void (*indexInsert)(Node *);
+static void (*indexRemove)(Node *);
+static size_t minimumSize = 1; // Smallest size a node may be split down to, indexed nodes must hold their links
+
+static Node *freeLists[SIZE_CLASSES]; // Free nodes bucketed by the power of two below their size (segregated fit)
+static void *buddyEnd; // End of the part of the heap split into buddy blocks, the rest is too small for one (buddy)
+
 /**
  * A function pointer that allocates memory in the heap to a given process. This process is given a pointer to a block
  * of memory with its requested size.
@@ -51,9 +72,66 @@ Node *freeNode(Node *node, size_t bytes)
     node->size = bytes;
     node->next = freeNode;
 
+    if (indexInsert != NULL) indexInsert(freeNode); // The new hole must be found by indexed algorithms
+
     return node;
 }
 
+/**
+ * Rounds a request up for the indexed algorithms so that once freed the node can hold its links, and so that the node
+ * after it stays aligned.
+ *
+ * @param bytes - requested bytes
+ * @return - bytes to be allocated
+ */
+static size_t indexedSize(size_t bytes)
+{
+    if (bytes < minimumSize) bytes = minimumSize;
+    return (bytes + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+}
+
+/**
+ * Finds the size class of a node, which is the power of two at or below its size.
+ *
+ * @param size - size of the node
+ * @return - index of the node's free list
+ */
+static size_t sizeClass(size_t size)
+{
+    return SIZE_CLASSES - 1 - __builtin_clzl(size);
+}
+
+/**
+ * Pushes a free node onto the front of the free list of its size class.
+ *
+ * @param node - free node to be added
+ */
+static void segregatedInsert(Node *node)
+{
+    size_t class = sizeClass(node->size);
+
+    FREE_LINKS(node)->prevFree = NULL;
+    FREE_LINKS(node)->nextFree = freeLists[class];
+
+    if (freeLists[class] != NULL) FREE_LINKS(freeLists[class])->prevFree = node;
+    freeLists[class] = node;
+}
+
+/**
+ * Unlinks a node from the free list of its size class.
+ *
+ * @param node - free node to be removed
+ */
+static void segregatedRemove(Node *node)
+{
+    FreeLinks *links = FREE_LINKS(node);
+
+    if (links->prevFree != NULL) FREE_LINKS(links->prevFree)->nextFree = links->nextFree;
+    else freeLists[sizeClass(node->size)] = links->nextFree;
+
+    if (links->nextFree != NULL) FREE_LINKS(links->nextFree)->prevFree = links->prevFree;
+}
+
 /**
  * The algorithm allocates memory by looking for the first free node with enough space to hold a new node and a struct,
  * even if the node is too big. Once a node has been found, its details are changed and a new free node is created if a
@@ -206,6 +284,175 @@ void *worstFit(size_t bytes)
     return NULL;
 }
 
+/**
+ * This algorithm keeps a separate list of free nodes for every power of two size class, so that only free nodes that
+ * could hold the request are looked at. The class of the request is searched first fit, after which any node in a
+ * bigger class is guaranteed to fit so the first one found is used. The node is then taken out of its list and split
+ * using the freeNode function if a new node can be created.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *segregatedFit(size_t bytes)
+{
+    if (bytes < 1) return NULL;
+    bytes = indexedSize(bytes);
+
+    for (size_t class = sizeClass(bytes); class < SIZE_CLASSES; class++)
+    {
+        for (Node *node = freeLists[class]; node != NULL; node = FREE_LINKS(node)->nextFree)
+        {
+            if (node->size < bytes) continue; // Only the class of the request can hold nodes too small
+
+            segregatedRemove(node);
+            if (node->size >= bytes + sizeof(Node) + minimumSize) return ((void *)(freeNode(node, bytes)) + sizeof(Node));
+
+            node->free = false;
+            return ((void *)(node) + sizeof(Node));
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Finds the order of a buddy block, which is the power of two of its size including its node.
+ *
+ * @param node - the buddy block
+ * @return - order of the block
+ */
+static size_t buddyOrder(Node *node)
+{
+    return SIZE_CLASSES - 1 - __builtin_clzl(node->size + sizeof(Node));
+}
+
+/**
+ * Finds the order of the smallest buddy block that can hold a request along with its node and, once freed, its links.
+ *
+ * @param bytes - requested bytes
+ * @return - order of the block
+ */
+static size_t buddyRequestOrder(size_t bytes)
+{
+    size_t total = sizeof(Node) + ((bytes < sizeof(FreeLinks)) ? sizeof(FreeLinks) : bytes);
+
+    if (total < bytes || total > ((size_t)(1) << (SIZE_CLASSES - 1))) return SIZE_CLASSES; // Can never fit
+    return SIZE_CLASSES - __builtin_clzl(total - 1);
+}
+
+/**
+ * This algorithm is a binary buddy allocator, where every block is a power of two in size and is aligned to its size
+ * from the start of the heap. Free blocks are kept in one free list per order using the segregated fit lists. The
+ * smallest order that can hold the request is found and the first block of that order or above is taken, which is then
+ * halved until it is the right size, with the upper half of each split left free as the buddy of the lower half. The
+ * blocks stay in address order in the list so the heap can still be printed.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *buddyFit(size_t bytes)
+{
+    size_t order = buddyRequestOrder(bytes);
+    size_t class = order - 1; // Blocks of an order have sizes in the class below it, as the node is not counted
+    Node *node = NULL;
+
+    if (bytes < 1 || order >= SIZE_CLASSES) return NULL;
+    while (class < SIZE_CLASSES && freeLists[class] == NULL) class++;
+    if (class >= SIZE_CLASSES) return NULL;
+
+    node = freeLists[class];
+    segregatedRemove(node);
+
+    /* Halve the block until it is the requested order, freeing the upper half each time */
+    for (size_t current = class + 1; current > order; current--)
+    {
+        size_t half = (size_t)(1) << (current - 1);
+        Node *buddy = (Node *)((void *)(node) + half);
+
+        buddy->free = true;
+        buddy->size = half - sizeof(Node);
+        buddy->prev = node;
+        buddy->next = node->next;
+        node->next->prev = buddy;
+        node->next = buddy;
+        node->size = half - sizeof(Node);
+
+        segregatedInsert(buddy);
+    }
+
+    node->free = false;
+    return ((void *)(node) + sizeof(Node));
+}
+
+/**
+ * Frees a buddy block, merging it with its buddy for as long as the buddy is also free and whole. The buddy of a block
+ * is found by flipping the bit of its order in its offset from the start of the heap, so no list needs to be walked.
+ *
+ * @param node - the node to be unallocated
+ */
+static void buddyRelease(Node *node)
+{
+    size_t order = buddyOrder(node);
+
+    while (order < SIZE_CLASSES - 1)
+    {
+        size_t offset = (size_t)((void *)(node) - (void *)(firstBlock));
+        Node *buddy = (Node *)((void *)(firstBlock) + (offset ^ ((size_t)(1) << order)));
+
+        /* The buddy must exist and be free, and not have been split into smaller blocks */
+        if ((void *)(buddy) + ((size_t)(1) << order) > buddyEnd) break;
+        if (buddy->free == false || buddy->size != node->size) break;
+
+        segregatedRemove(buddy);
+        if (buddy < node)
+        {
+            Node *swap = node;
+            node = buddy;
+            buddy = swap;
+        }
+
+        node->next = buddy->next; // Un-link the upper half
+        buddy->next->prev = node;
+        node->size += buddy->size + sizeof(Node);
+        order++;
+    }
+
+    node->free = true;
+    segregatedInsert(node);
+}
+
+/**
+ * Splits the heap into the biggest buddy blocks that fit, each aligned to its size from the start of the heap. Any
+ * space at the end too small for a block is left out.
+ *
+ * @param size - size of heap in bytes
+ */
+static void buddySplitHeap(size_t size)
+{
+    size_t offset = 0;
+    size_t minimum = (size_t)(1) << buddyRequestOrder(1);
+    Node *last = NULL;
+
+    while (size - offset >= minimum)
+    {
+        size_t order = SIZE_CLASSES - 1 - __builtin_clzl(size - offset);
+        if (offset != 0 && (size_t)__builtin_ctzl(offset) < order) order = __builtin_ctzl(offset); // Keep it aligned
+
+        Node *node = (Node *)((void *)(firstBlock) + offset);
+        node->free = true;
+        node->size = ((size_t)(1) << order) - sizeof(Node);
+        node->prev = (last == NULL) ? node : last;
+        node->next = firstBlock;
+
+        if (last != NULL) last->next = node;
+        firstBlock->prev = node;
+        segregatedInsert(node);
+
+        last = node;
+        offset += (size_t)(1) << order;
+    }
+    buddyEnd = (void *)(firstBlock) + offset;
+}
+
 /**
  * Initialises first node which is a hole that takes up the entire heap. The node structure is then given information
  * about it's self. Null checks are conducted to make sure that memory allocation has worked.
@@ -223,8 +470,21 @@ void initialise(void *memory , size_t size, char *algorithm)
     else if (!strcmp(algorithm, "BestFit")) allocate = &bestFit;
     else if (!strcmp(algorithm, "WorstFit")) allocate = &worstFit;
     else if (!strcmp(algorithm, "NextFit")) allocate = &nextFit;
+    else if (!strcmp(algorithm, "SegregatedFit")) allocate = &segregatedFit;
+    else if (!strcmp(algorithm, "Buddy")) allocate = &buddyFit;
     else allocate = &firstFit; // If anything else, default to firstFit.
 
+    /* Only segregated fit keeps an index of its free nodes */
+    indexInsert = indexRemove = NULL;
+    minimumSize = 1;
+    if (allocate == &segregatedFit || allocate == &buddyFit)
+    {
+        indexInsert = &segregatedInsert;
+        indexRemove = &segregatedRemove;
+        minimumSize = sizeof(FreeLinks);
+        memset(freeLists, 0, sizeof(freeLists));
+    }
+
     Node *node = (Node *)(memory); // Assign struct to start of heap
 
     if (size == 0 || node == NULL)
@@ -239,12 +499,22 @@ void initialise(void *memory , size_t size, char *algorithm)
     node->prev = node;
 
     firstBlock = lastUsed = node; // Sets up lastUsed in all cases for readability
+
+    /* Buddy blocks are split and merged by the buddy algorithm itself rather than the index hooks */
+    if (allocate == &buddyFit)
+    {
+        indexInsert = indexRemove = NULL;
+        buddySplitHeap(size);
+    }
+    else if (indexInsert != NULL) indexInsert(node);
 }
 
 /**
  * Deallocate memory by setting the node->free to true so that it can be used in allocating. If there is a free node
  * before or after it, said node, is disconnected and the current node is then grown into it creating one big node.
- * Also, if nodes are being coalesced the lastUsed node is preserved if its node is unlinked.
+ * Also, if nodes are being coalesced the lastUsed node is preserved if its node is unlinked. Indexed algorithms have the
+ * neighbours taken out of their index before being joined and the resulting node added back. Buddy blocks are instead
+ * only merged with their buddies, moving back from any header that allocate_aligned put inside one to its real node.
  *
  * @param memory - the memory pointer to be unallocated
  */
@@ -254,6 +524,13 @@ void deallocate(void *memory)
     if(node == NULL) return; // Make sure that the input is a valid pointer
     node --; // Moves back one node struct to the actual node struct
 
+    if (allocate == &buddyFit)
+    {
+        if (node->next == NULL) node = node->prev; // Headers inside aligned blocks aren't in the list
+        buddyRelease(node);
+        return;
+    }
+
     Node *prevNode = node->prev;
     Node *nextNode = node->next;
 
@@ -264,6 +541,7 @@ void deallocate(void *memory)
     {
         /* If in next fit and coalesced node is last used, update last used to preserve */
         if (lastUsed == nextNode) lastUsed = node;
+        if (indexRemove != NULL) indexRemove(nextNode);
 
         node->next = nextNode->next;
         node->size += nextNode->size + sizeof(Node); // Increase main node size
@@ -275,12 +553,97 @@ void deallocate(void *memory)
     {
         /* If in next fit and coalesced node is last used, update last used to preserve */
         if (lastUsed == node) lastUsed = prevNode;
+        if (indexRemove != NULL) indexRemove(prevNode);
 
         prevNode->next = node->next; // Un-link old node
         prevNode->size += node->size + sizeof(Node); // Increase main node size
 
         if (node->next != node) node->next->prev = prevNode;
+        node = prevNode;
+    }
+
+    if (indexInsert != NULL) indexInsert(node);
+}
+
+/**
+ * Allocates memory whose address is a multiple of the alignment, such as a cache line or a page, using the chosen
+ * algorithm. Enough extra bytes are allocated that an aligned address with room for a node in front of it is always
+ * inside the node found. The gap in front then becomes a node of its own and is deallocated, as is any space left after
+ * the request, so neither is wasted. Buddy blocks can't be split at arbitrary addresses, so unless a buddy block already
+ * happens to be aligned a bigger one is taken and the memory handed out from an aligned address inside it, behind a
+ * header that is in no list and whose prev is the block's real node. The memory is deallocated with deallocate as
+ * normal.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @param alignment - power of two the memory address must be a multiple of
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *allocate_aligned(size_t bytes, size_t alignment)
+{
+    size_t lead = sizeof(Node) + minimumSize; // Smallest gap that can be a node of its own
+
+    if (bytes < 1 || alignment == 0 || (alignment & (alignment - 1)) != 0) return NULL;
+    if (alignment < sizeof(size_t)) alignment = sizeof(size_t); // Keeps the nodes of segregated fit aligned
+
+    if (allocate == &buddyFit)
+    {
+        void *memory = allocate(bytes);
+        if (memory == NULL || (size_t)(memory) % alignment == 0) return memory;
+        deallocate(memory);
+
+        /* Room for the real node, the interior header and the request from wherever the alignment falls */
+        if (bytes > ~(size_t)(0) - alignment - sizeof(Node)) return NULL;
+        memory = allocate(bytes + alignment + sizeof(Node));
+        if (memory == NULL) return NULL;
+
+        Node *node = (Node *)(memory) - 1;
+        Node *interior = (Node *)(((size_t)(memory) + sizeof(Node) + alignment - 1) & ~(alignment - 1)) - 1;
+
+        interior->free = false;
+        interior->size = (size_t)(memory) + node->size - (size_t)(interior + 1);
+        interior->prev = node;
+        interior->next = NULL;
+        return interior + 1;
+    }
+
+    if (bytes > ~(size_t)(0) - alignment - 2 * lead) return NULL; // Would overflow once padded
+    bytes = indexedSize(bytes); // Once freed the node must hold its links
+
+    void *memory = allocate(bytes + alignment + lead);
+    if (memory == NULL) return NULL;
+
+    Node *node = (Node *)(memory) - 1;
+    size_t gap = (((size_t)(memory) + alignment - 1) & ~(alignment - 1)) - (size_t)(memory);
+
+    /* Split the gap in front into a node of its own and free it, joining it to any free node before it */
+    if (gap != 0)
+    {
+        while (gap < lead) gap += alignment; // The gap must be big enough to be a node
+        Node *alignedNode = (Node *)((void *)(node) + gap);
+
+        alignedNode->free = false;
+        alignedNode->size = node->size - gap;
+        alignedNode->prev = node;
+        alignedNode->next = node->next;
+        node->next->prev = alignedNode;
+        node->next = alignedNode;
+        node->size = gap - sizeof(Node);
+
+        deallocate(memory);
+        node = alignedNode;
     }
+
+    /* Free what is left after the request, joining it to any free node after it */
+    if (node->size >= bytes + sizeof(Node) + minimumSize)
+    {
+        Node *tail = freeNode(node, bytes)->next;
+
+        if (indexRemove != NULL) indexRemove(tail);
+        tail->free = false;
+        deallocate((void *)(tail) + sizeof(Node));
+    }
+
+    return (void *)(node) + sizeof(Node);
 }
 
 /**
@@ -37,7 +37,7 @@ typedef struct _Node
 
 /* Function names */
 
-void* (*allocate)(size_t); // Function pointer to one of the algorithm functions
+extern void* (*allocate)(size_t); // Function pointer to one of the algorithm functions
 
 Node *freeNode(Node *node, size_t bytes);
 
@@ -49,8 +49,14 @@ void *bestFit(size_t bytes);
 
 void *worstFit(size_t bytes);
 
+void *segregatedFit(size_t bytes);
+
+void *buddyFit(size_t bytes);
+
 void initialise(void *memory , size_t size, char *algorithm);
 
+void *allocate_aligned(size_t bytes, size_t alignment);
+
 void deallocate(void *memory);
 
 void memoryManager_printf();
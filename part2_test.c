@@ -21,7 +21,7 @@ void firstFitTest()
     size_t nodeSize = sizeof(Node);
 
     printf("---------- Initialising Memory Manager ----------\n");
-    size_t heapSize = 200;
+    size_t heapSize = 136 + 4 * nodeSize; // 200 bytes when sizeof(Node) = 16
     void *heap = malloc(heapSize);
     initialise(heap, heapSize, NULL);
     memoryManager_printf(); // prints one node with size of 184 as sizeof(Node) = 16
@@ -77,7 +77,7 @@ void firstFitTest()
            " even though it has more room than needed.\n");
     memoryManager_printf();
 
-    void *test7 = allocate(180); // Allocating just under maximum amount as total space is (200 - 16) 184;
+    void *test7 = allocate(heapSize - nodeSize - 4); // Allocating just under maximum amount of (200 - sizeof(Node))
     node = (Node *)(test7 - sizeof(Node)); // Setting up node pointer for allocated node
     printf("No room test : ");
 
@@ -146,7 +146,7 @@ void worstFitTest()
 {
     printf("---------- Initialising Memory Manager ----------\n");
     printf("\n -- Starting memory list :\n");
-    size_t size = 200;
+    size_t size = 120 + 5 * sizeof(Node); // 200 bytes when sizeof(Node) = 16
     void *heap = malloc(size);
     initialise(heap, size, "WorstFit");
     Node *node;
@@ -188,7 +188,7 @@ void nextFitTest()
 {
     printf("---------- Initialising Memory Manager ----------\n");
     printf("\n -- Starting memory list :\n");
-    size_t size = 240;
+    size_t size = 144 + 6 * sizeof(Node); // 240 bytes when sizeof(Node) = 16
     void *heap = malloc(size);
     initialise(heap, size, "NextFit");
 
@@ -256,9 +256,158 @@ void nextFitTest()
     free(heap);
 }
 
+/**
+ * Function that test the functionality of the segregated fit algorithm
+ */
+void segregatedFitTest()
+{
+    printf("---------- Initialising Memory Manager ----------\n");
+    printf("\n -- Starting memory list :\n");
+    size_t size = 1024;
+    void *heap = malloc(size);
+    initialise(heap, size, "SegregatedFit");
+    Node *node;
+
+    void *test1 = allocate(100);
+    void *test2 = allocate(20);
+    void *test3 = allocate(200);
+    void *test4 = allocate(20);
+    void *test5 = allocate(40);
+    memoryManager_printf();
+
+    printf("---------- Segregated Fit Allocation Test ----------\n");
+    printf("\n -- Deallocate blocks 1 and 3 so that holes of two different size classes are available.\n");
+
+    deallocate(test1);
+    deallocate(test3);
+    memoryManager_printf();
+
+    printf(" -- Allocating 150 bytes should skip the 100 byte hole as it is in a smaller size class and use the 200 byte "
+           "hole.\n");
+    node = (Node *)(test3 - sizeof(Node)); // Setting up node pointer to the 200 byte hole
+
+    void *test6 = allocate(150);
+    memoryManager_printf();
+
+    printf("Segregated fit allocation test : ");
+    if (test6 == test3 && node->free == false && node->size >= 150) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("---------- Segregated Fit Coalescing Test ----------\n");
+    printf(" -- Deallocating everything should coalesce back into one node that can be allocated whole.\n");
+
+    deallocate(test2);
+    deallocate(test5);
+    deallocate(test6);
+    deallocate(test4);
+    memoryManager_printf();
+
+    node = (Node *)(heap);
+    void *test7 = allocate(size - sizeof(Node));
+
+    printf("Segregated fit coalescing test : ");
+    if (test7 == (void *)(node) + sizeof(Node) && node->free == false) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that test the functionality of the buddy algorithm
+ */
+void buddyTest()
+{
+    printf("---------- Initialising Memory Manager ----------\n");
+    printf("\n -- Starting memory list :\n");
+    size_t size = 1024;
+    void *heap = malloc(size);
+    initialise(heap, size, "Buddy");
+    memoryManager_printf();
+
+    printf("---------- Buddy Allocation Test ----------\n");
+    printf(" -- Allocating should halve the heap until the smallest power of two block that holds the request and its "
+           "node is left.\n");
+
+    void *test1 = allocate(20);
+    void *test2 = allocate(100);
+    void *test3 = allocate(20);
+    memoryManager_printf();
+
+    Node *node = (Node *)(test1 - sizeof(Node));
+    size_t blockSize = node->size + sizeof(Node);
+
+    printf("Buddy allocation test : ");
+    /* The first block fits the request, is a power of two, and its buddy is the next block allocated to the same size */
+    if (node->free == false && node->size >= 20 && (blockSize & (blockSize - 1)) == 0 &&
+        test3 == test1 + blockSize) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("---------- Buddy Coalescing Test ----------\n");
+    printf(" -- Deallocating everything should merge each block with its buddy back into the whole heap.\n");
+
+    deallocate(test1);
+    deallocate(test2);
+    deallocate(test3);
+    memoryManager_printf();
+
+    node = (Node *)(heap);
+    printf("Buddy coalescing test : ");
+    if (node->free == true && node->size == size - sizeof(Node) && node->next == node) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
 /**
  * Test harness to test functionality of the memory manager.
  */
+/**
+ * Function that tests that aligned allocation returns aligned memory, that the gaps around it are freed rather than
+ * wasted, and that everything coalesces again once deallocated.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void alignedTest(char *algorithm)
+{
+    printf("---------- Initialising Memory Manager ----------\n");
+    size_t size = 4096;
+    void *heap = malloc(size);
+    initialise(heap, size, algorithm);
+
+    printf("---------- Aligned Allocation Test ----------\n");
+    printf(" -- Each block should start on its alignment, with a free node in front of it where there was a gap.\n");
+
+    void *test1 = allocate(10);
+    void *test2 = allocate_aligned(100, 64);
+    void *test3 = allocate_aligned(30, 256);
+    memoryManager_printf();
+
+    /* Buddy blocks can't be split, so aligned memory inside one has a header pointing back to the block instead */
+    Node *node = (Node *)(test2 - sizeof(Node));
+    bool_type front = (strcmp(algorithm, "Buddy") == 0) ?
+                      (node->next == NULL && node->prev->free == false && (void *)(node->prev) < (void *)(node)) :
+                      (node->prev->free == true || node->prev == (Node *)(test1 - sizeof(Node)));
+    printf("Aligned allocation test : ");
+    if (test1 != NULL && (size_t)(test2) % 64 == 0 && (size_t)(test3) % 256 == 0 && node->size >= 100 &&
+        front == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("---------- Aligned Coalescing Test ----------\n");
+    printf(" -- Deallocating everything should leave a single free node.\n");
+
+    deallocate(test2);
+    deallocate(test1);
+    deallocate(test3);
+    memoryManager_printf();
+
+    node = (Node *)(heap);
+    printf("Aligned coalescing test : ");
+    if (node->free == true && node->size == size - sizeof(Node) && node->next == node) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
 void testHarness()
 {
     printf("---------- Testing Begins ----------\n");
@@ -283,6 +432,21 @@ void testHarness()
     nextFitTest();
     printf("\n---------- End Next Fit Test ----------\n");
 
+    printf("\n---------- Begin Segregated Fit Test ----------\n");
+    segregatedFitTest();
+    printf("\n---------- End Segregated Fit Test ----------\n");
+
+    printf("\n---------- Begin Buddy Test ----------\n");
+    buddyTest();
+    printf("\n---------- End Buddy Test ----------\n");
+
+    printf("\n---------- Begin Aligned Allocation Test ----------\n");
+    alignedTest("FirstFit");
+    alignedTest("BestFit");
+    alignedTest("SegregatedFit");
+    alignedTest("Buddy");
+    printf("\n---------- End Aligned Allocation Test ----------\n");
+
     printf("\n---------- Testing Ends ----------");
 }
 
@@ -9,12 +9,293 @@
  *
  */
 
+#define _GNU_SOURCE // For mremap
 #include "part3.h"
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <linux/futex.h>
 
-pthread_mutex_t lock;
+#define CACHE_GRANULE 16 // Size classes of the thread caches are multiples of this many bytes
+#define CACHE_CLASSES 16 // Number of size classes, so requests of up to 256 bytes are cached
+#define CACHE_BATCH 8 // Number of blocks taken from the shared list when a class is empty
+#define CACHE_LIMIT 32 // Number of blocks a class can hold before half of them are flushed
+#define BATCH_STACK 64 // Pointers a batch deallocation sorts on the stack rather than in a copy it allocates
 
-Node *firstBlock; // Initialise pointer to first node of list
-Node *lastUsed; // Initialise pointer that points to last accessed node (specific to nextFit)
+#define SIZE_CLASSES (sizeof(size_t) * 8) // One segregated free list per power of two a size can have
+
+#define TLSF_SL_LOG2 4 // Each power of two is split into 1 << TLSF_SL_LOG2 second level lists by TLSF
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_FL_COUNT (SIZE_CLASSES - TLSF_SL_LOG2 + 1) // First level 0 holds every size below TLSF_SL_COUNT
+
+#define ARENA_MINIMUM 4096 // Smallest size in bytes an arena is given, fewer arenas are used for smaller heaps
+
+#define NODE_ZEROED 1 // Flag of a free node whose memory, other than any links written to it, is known to be all zero
+#define NODE_SEGMENT 2 // Flag of the first node of an arena or a mapped segment, which never joins the node before it
+#define NODE_MAPPED 4 // Flag of a block in a mapping of its own outside of every arena
+#define NODE_INTERIOR 8 // Flag of a header inside an aligned buddy block, whose prev is the block's real node
+
+#define SEGMENT_MINIMUM (64 * 1024) // Size in bytes of the first segment a growable heap maps, each after is double
+#define SEGMENT_MAXIMUM (64 * 1024 * 1024) // Segments stop doubling at this size unless a request needs more
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024) // Heaps that map their own memory are a multiple of this and aligned to it
+
+#define LOCK_MUTEX 0 // Arenas are guarded by a pthread mutex
+#define LOCK_NONE 1 // Arenas aren't guarded at all, for heaps only ever used by one thread
+#define LOCK_SPIN 2 // Arenas are guarded by a test and test and set spinlock with exponential backoff
+#define LOCK_TICKET 3 // Arenas are guarded by a ticket lock, which is handed over in the order it was asked for
+#define LOCK_FUTEX 4 // Arenas are guarded by a mutex that spins for a while before sleeping on a futex
+#define SPIN_BACKOFF_LIMIT 1024 // Most pauses a spinning thread waits before it yields the processor instead
+#define LOCK_SHARED 5 // Arenas are guarded by a reader-writer lock, whose shared side region locked operations take
+#define FUTEX_SPINS 100 // Looks a thread takes at a futex mutex before it goes to sleep
+
+#define REGION_LOCKS 64 // Number of address ranges an arena with region locking is split into, each with its own lock
+#define REGION_TAIL REGION_LOCKS // Extra lock, last in order, guarding the link from the first node back to the last
+
+#define COMBINE_IDLE 0 // State of a combining slot with no request in it
+#define COMBINE_ALLOCATE 1 // State of a combining slot asking for a block to be allocated
+#define COMBINE_RELEASE 2 // State of a combining slot asking for a block to be deallocated
+#define COMBINE_BUSY 3 // State of a combining slot whose request a combiner has taken on
+#define COMBINE_DONE 4 // State of a combining slot whose request has been carried out
+#define COMBINE_PASSES 4 // Most passes a combiner makes over the slots, it stops early after one finding nothing
+#define COMBINE_SPINS 64 // Pauses a thread waits on its slot between tries at the lock before it yields instead
+
+#define COMPACT_FREE 1 // Bit of a compact header set while its block is free
+#define COMPACT_PREV_FREE 2 // Bit of a compact header set while the block before it is free and has a footer
+#define COMPACT_MINIMUM (4 * sizeof(size_t)) // Smallest compact block, which once free holds its links and footer
+#define COMPACT_HEADER(block) (*(size_t *)(block))
+#define COMPACT_SIZE(block) (COMPACT_HEADER(block) & ~(sizeof(size_t) - 1)) // Size of a compact block with its header
+#define COMPACT_LINKS(block) ((FreeLinks *)((void *)(block) + sizeof(size_t)))
+
+#define SMALL_GRANULE 8 // Chunk size of the smallest class of the small block tier
+#define SMALL_CLASSES 4 // Number of chunk sizes in the small block tier, each double the last
+#define SMALL_MAXIMUM (SMALL_GRANULE << (SMALL_CLASSES - 1)) // Largest request served by the small block tier
+#define SMALL_SHARE 4 // The small block tier takes up to one in this many bytes of a heap
+
+#define POOL_SLAB_SIZE 4096 // Bytes requested from the heap each time a pool runs out of objects
+
+#define STACK_TAG_SHIFT 48 // Pointers fit in the low 48 bits of a lock-free stack's head, the bits above count pushes
+#define STACK_POINTER(head) ((void *)(size_t)((head) & ((1ULL << STACK_TAG_SHIFT) - 1)))
+#define STACK_TAG(head) ((head) >> STACK_TAG_SHIFT)
+#define STACK_LINK(item, offset) ((void **)((void *)(item) + (offset))) // Items are linked through their memory
+
+#define CACHE_LINK(node) (*(Node **)((void *)(node) + sizeof(Node))) // Cached nodes are linked through their memory
+#define PENDING_LINK(manager, node) (*(Node **)((void *)(node) + (manager)->headerSize)) // Pending blocks are as well
+
+/**
+ * Per-thread cache of allocated nodes, binned by size class, that allocate and deallocate use without locking. The
+ * nodes stay allocated in the shared list while cached so that no other thread can use or coalesce them.
+ */
+typedef struct _ThreadCache
+{
+    MemoryManager *manager; // Heap the cached nodes belong to
+    struct _ThreadCache *next; // Other caches of the same heap, so that they can be freed along with it
+    struct _ThreadCache *prev;
+    Node *bins[CACHE_CLASSES + 1];
+    size_t counts[CACHE_CLASSES + 1];
+}ThreadCache;
+
+/**
+ * Links stored in the memory of a free node that chain it into the free list of its size class.
+ */
+typedef struct _FreeLinks
+{
+    Node *nextFree;
+    Node *prevFree;
+}FreeLinks;
+
+#define FREE_LINKS(node) ((FreeLinks *)((void *)(node) + sizeof(Node)))
+
+/**
+ * Links stored in the memory of a free node that place it in the red-black tree of free nodes used by best fit. The
+ * tree is ordered by size and then by address, so equal sized nodes are told apart.
+ */
+typedef struct _TreeLinks
+{
+    struct _Node *child[2]; // Left and right children
+    struct _Node *parent;
+    bool_type red;
+}TreeLinks;
+
+#define TREE_LINKS(node) ((TreeLinks *)((void *)(node) + sizeof(Node)))
+
+/**
+ * Links stored in the memory of a free node that place it in the pairing heap of free nodes used by worst fit, where
+ * every node is at least as big as its children.
+ */
+typedef struct _HeapLinks
+{
+    struct _Node *child; // First child
+    struct _Node *sibling; // Next sibling
+    struct _Node *prev; // Previous sibling, or parent if the node is the first child
+}HeapLinks;
+
+#define HEAP_LINKS(node) ((HeapLinks *)((void *)(node) + sizeof(Node)))
+
+/**
+ * Lock of an arena, which works as whichever of the LOCK_ policies the heap was created with.
+ */
+typedef struct _ArenaLock
+{
+    int policy;
+    pthread_mutex_t mutex; // (mutex)
+    unsigned int word; // 1 while held (spin), or 0 free, 1 held and 2 held with sleepers waiting (futex)
+    unsigned int ticket; // Next ticket to be handed out (ticket)
+    unsigned int serving; // Ticket of the thread holding the lock (ticket)
+    pthread_rwlock_t rwlock; // (shared)
+    size_t served; // Requests carried out in the lock's region while it was held, only counted for region locks
+}ArenaLock;
+
+/**
+ * An arena is one slice of the heap with its own list, lock and index of free nodes, so that threads working in
+ * different arenas don't wait on each other.
+ */
+typedef struct _Arena
+{
+    ArenaLock lock;
+    MemoryManager *manager; // Heap the arena belongs to
+
+    Node *firstBlock; // First node of the arena's list
+    Node *lastUsed; // Last accessed node (specific to nextFit)
+
+    Node *freeLists[SIZE_CLASSES]; // Free nodes bucketed by the power of two below their size (segregated fit)
+    void *buddyEnd; // End of the part of the arena split into buddy blocks, the rest is too small for one (buddy)
+    Node *treeRoot; // Root of the tree of free nodes ordered by size (best fit)
+    Node *heapRoot; // Root of the heap of free nodes, which is always the largest (worst fit)
+
+    size_t tlsfFirstMap; // Bit set for each first level with a non empty list (TLSF)
+    unsigned int tlsfSecondMap[TLSF_FL_COUNT]; // Bit set for each non empty second level list (TLSF)
+    Node *tlsfLists[TLSF_FL_COUNT][TLSF_SL_COUNT]; // Free nodes by first and second level (TLSF)
+
+    Node *pending; // Lock-free stack of deferred or remote frees waiting to be released, linked through their memory
+    size_t combined; // Requests a combiner holding the lock carried out for other threads (flat combining)
+
+    ArenaLock *regionLocks; // Lock of each address range of the arena, then the tail lock/NULL without region locking
+    size_t regionSpan; // Bytes in each address range
+
+    Node spanned; // Stands in as the only node of the arena's slice while a block from an earlier arena covers it
+}Arena;
+
+/**
+ * One chunk size of the small block tier. Chunks have no node, instead each one has a bit in a bitmap that is set
+ * while the chunk is in use, so free chunks are found a word at a time and taken with a compare and swap.
+ */
+typedef struct _SmallClass
+{
+    void *start; // First chunk
+    void *end; // End of the last chunk
+    size_t chunkSize;
+    size_t words; // Number of 64 bit words in the bitmap, each covering 64 chunks
+    unsigned long long *bitmap;
+    size_t hint; // Word the last chunk was found in, where the next search starts
+}SmallClass;
+
+/**
+ * Header at the start of each segment a growable heap maps once it is full. The rest of the segment is a node that is
+ * added to the end of the list of the arena that needed it.
+ */
+typedef struct _Segment
+{
+    struct _Segment *next; // Segment mapped before this one
+    Arena *arena; // Arena the segment was added to
+    size_t size; // Size of the mapping including this header
+}Segment;
+
+/**
+ * Slot a thread publishes its requests in while a heap uses flat combining, so that whichever thread holds an arena's
+ * lock can carry them out for it. Slots are kept until the heap is destroyed and are reused once their thread exits.
+ */
+typedef struct _CombineSlot
+{
+    struct _CombineSlot *next; // Other slots of the same heap
+    bool_type active; // Set while a thread owns the slot
+    int state; // One of the COMBINE_ states
+    Node *(*search)(Arena *, size_t); // Unlocked search of the algorithm to allocate with (allocate)
+    size_t bytes; // Requested bytes (allocate)
+    Node *node; // Node to be deallocated (release), or the node allocated/NULL if the arena had no room (allocate)
+}CombineSlot;
+
+/**
+ * A heap along with the algorithm chosen for it. Every heap has its own arenas, locks and thread caches, so heaps
+ * never wait on each other and any number of them can be used at once.
+ */
+struct _MemoryManager
+{
+    Arena *arenas; // Arenas the heap is split into
+    size_t arenaCount;
+    size_t arenaSpan; // Size of every arena but the last, which also takes what is left over
+    void *arenaEnd; // End of the last arena
+    size_t nextArena; // Counts threads as they are given arenas round-robin
+    pthread_key_t arenaKey; // Key to the index, plus one, of each thread's arena
+
+    Node *(*fit)(Arena *, size_t); // Unlocked search of the chosen algorithm, used by the thread caches
+    void *(*allocate)(size_t); // Locked allocation of the chosen algorithm, used by the global functions
+
+    /* Algorithms that index their free nodes set these so that splitting and coalescing keep the index up to date */
+    void (*indexInsert)(Arena *, Node *);
+    void (*indexRemove)(Arena *, Node *);
+    size_t minimumSize; // Smallest size a node may be split down to, indexed nodes must hold their links
+    size_t headerSize; // Bytes in front of the memory of every block, which are a node unless the heap is compact
+
+    void (*release)(Arena *, Node *); // Unlocked deallocation of the chosen algorithm
+
+    bool_type threadCaching; // Whether allocation and deallocation go through the thread caches
+    pthread_key_t cacheKey; // Key to each thread's cache, its destructor drains the cache when the thread exits
+    pthread_mutex_t cacheLock; // Guards the list of caches
+    ThreadCache *caches; // Caches of the threads that have used the heap
+
+    bool_type smallBlocks; // Whether small requests are served by the small block tier
+    SmallClass smallClasses[SMALL_CLASSES];
+    void *smallStart; // Region at the end of the heap set aside for the small block tier
+    void *smallEnd;
+
+    bool_type growable; // Whether segments are mapped when the heap is full
+    bool_type spanning; // Whether requests no arena can hold are given blocks running across free arenas
+    size_t trimThreshold; // Free nodes at least this big have their whole pages released as they are freed, 0 never
+
+    void *mapping; // Memory the heap mapped for itself, which is unmapped along with it/NULL if it was given memory
+    size_t mappingSize;
+
+    size_t mapThreshold; // Requests at least this big are given a mapping of their own, 0 never
+    pthread_mutex_t mapLock; // Guards the list of mapped blocks
+    Node *mappedBlocks; // Blocks with mappings of their own, so that they are unmapped along with the heap
+
+    bool_type deferred; // Whether deallocation leaves blocks pending instead of coalescing them straight away
+    unsigned int sweepInterval; // Milliseconds between the sweeper releasing pending blocks, 0 if there is no sweeper
+    pthread_t sweeper;
+    pthread_mutex_t sweepLock; // Guards sweeping and lets the sweeper be woken to stop
+    pthread_cond_t sweepCond;
+    bool_type sweeping; // Cleared to stop the sweeper
+    Segment *segments; // Segments mapped so far, newest first
+
+    bool_type combining; // Whether allocation and deallocation are carried out by whichever thread holds the lock
+    pthread_key_t combineKey; // Key to each thread's slot, its destructor frees the slot up for another thread
+    CombineSlot *slots; // Slots of every thread that has used the heap, only ever pushed onto
+
+    bool_type remoteFrees; // Whether blocks deallocated by threads other than their arena's owner are left pending
+    bool_type regionLocking; // Whether first and next fit lock only the regions of the list they work on
+    bool_type regionFromLast; // Whether region locked searches start from the last node used (next fit)
+    bool_type lockFreeClasses; // Whether small blocks are handed out and taken back through lock-free stacks
+    unsigned long long classStacks[CACHE_CLASSES + 1]; // Tagged heads of the allocated nodes of each size class
+};
+
+/**
+ * A pool of objects of one size carved out of slabs taken from the heap. Free objects are kept on a lock-free stack
+ * linked through their own memory, whose head packs a pointer with a count of pushes so that a pop can't succeed on a
+ * head that was popped and pushed back in between (the ABA problem).
+ */
+struct _Pool
+{
+    unsigned long long head; // Tagged pointer to the first free object
+    void *slabs; // Slabs taken from the heap, linked through their first word
+    size_t objectSize;
+    MemoryManager *manager; // Heap the slabs are taken from
+};
+
+static MemoryManager *defaultManager = NULL; // Heap used by initialise and the global functions
+static MemoryOptions defaultOptions = {0}; // Settings the memoryManager_ functions give heaps set up by initialise
 
 /**
  * A function pointer that allocates memory in the heap to a given process. This process is given a pointer to a block
@@ -41,6 +322,7 @@ Node *freeNode(Node *node, size_t bytes)
     Node *freeNode = (Node *) (((void *)(node) + sizeof(Node)) + bytes); // New empty node
 
     freeNode->free = true;
+    freeNode->flags = node->flags & NODE_ZEROED; // What is split off is as clean as the node it came from
     freeNode->size = node->size - totalBytes;
     freeNode->prev = node;
     freeNode->next = node->next;
@@ -55,278 +337,4360 @@ Node *freeNode(Node *node, size_t bytes)
 }
 
 /**
- * The algorithm allocates memory by looking for the first free node with enough space to hold a new node and a struct,
- * even if the node is too big. Once a node has been found, its details are changed and a new free node is created if a
- * hole is created. This function also locks the current thread when accessing the main pool of memory and unlocks it
- * when returning the memory address.
+ * Support function for the algorithms that clears the zeroed flag of a node being handed out while the lock is still
+ * held, if the heap has lock-free size classes and the node fits one. Once deallocated such a node is pushed onto its
+ * class without any lock, where the flag can't be cleared without racing a neighbour's release, and callocate trusts
+ * the flag of whatever the class hands out next.
  *
- * @param bytes - requested bytes to be allocated
- * @return - void memory pointer/NULL if can't be allocated
+ * @param arena - arena the node is in
+ * @param node - allocated node/NULL
+ * @return - the node
  */
-void *firstFit(size_t bytes)
+static Node *handOut(Arena *arena, Node *node)
 {
-    size_t totalBytes = bytes + sizeof(Node); // total size of a new node + memory block
+    size_t class = (node == NULL) ? 0 : node->size / CACHE_GRANULE;
 
-    if (bytes < 1) return NULL;
+    if (arena->manager->lockFreeClasses == true && class >= 1 && class <= CACHE_CLASSES) node->flags &= ~NODE_ZEROED;
+    return node;
+}
+
+/**
+ * Support function for the indexed algorithms that takes a node out of the index and allocates it. If what is left
+ * after the requested bytes is big enough to be a node of its own, it is split off using the freeNode function and
+ * added to the index.
+ *
+ * @param arena - arena the node is in
+ * @param node - free node chosen by the algorithm
+ * @param bytes - the amount of memory to be allocated
+ * @return - the allocated node
+ */
+static Node *useNode(Arena *arena, Node *node, size_t bytes)
+{
+    MemoryManager *manager = arena->manager;
 
-    pthread_mutex_lock(&lock);
-    Node *node = firstBlock->prev;
+    manager->indexRemove(arena, node);
 
-    do
+    if (node->size >= bytes + sizeof(Node) + manager->minimumSize)
     {
-        node = node->next; // Increment through the list
-        if (node->free == false || node->size < bytes) continue;  // Don't use non free nodes or too small nodes
+        freeNode(node, bytes);
+        manager->indexInsert(arena, node->next);
+        return handOut(arena, node);
+    }
 
-        /* If block found has exact size or is exact size of memory + size of node allocate */
-        if (node->size <= totalBytes)
-        {
-            node->free = false;
-            pthread_mutex_unlock(&lock);
-            return (void *)((void *)(node) + sizeof(Node));
-        }
-        pthread_mutex_unlock(&lock);
-        return (void *)((void *)freeNode(node, bytes)) + sizeof(Node);
+    node->free = false;
+    return handOut(arena, node);
+}
 
-    }while(node->next != firstBlock); // End of loop met
+/**
+ * Rounds a request up for the indexed algorithms so that once freed the node can hold its links, and so that the node
+ * after it stays aligned.
+ *
+ * @param arena - arena the request is for
+ * @param bytes - requested bytes
+ * @return - bytes to be allocated
+ */
+static size_t indexedSize(Arena *arena, size_t bytes)
+{
+    if (bytes < arena->manager->minimumSize) bytes = arena->manager->minimumSize;
+    return (bytes + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+}
 
-    pthread_mutex_unlock(&lock);
-    return NULL;
+/**
+ * Finds the size class of a node, which is the power of two at or below its size.
+ *
+ * @param size - size of the node
+ * @return - index of the node's free list
+ */
+static size_t sizeClass(size_t size)
+{
+    return SIZE_CLASSES - 1 - __builtin_clzl(size);
 }
 
 /**
- * This algorithm is similar to first fit but rather than starting from the first block every time when looping, it
- * starts from the last node accessed. This means that after accessing/creating a new node, a variable - lastUsed - is
- * updated to update the starting point. This variable is set to the start block at the start of the program. Once a
- * node has been found, its details are changed and a new free node is created if a hole is created. This function also
- * locks the current thread when accessing the main pool of memory and unlocks it when returning the memory address.
+ * Pushes a free node onto the front of the free list of its size class.
  *
- * @param bytes - requested bytes to be allocated
- * @return - void memory pointer/NULL if can't be allocated
+ * @param arena - arena the node is in
+ * @param node - free node to be added
  */
-void *nextFit(size_t bytes)
+static void segregatedInsert(Arena *arena, Node *node)
 {
-    size_t totalBytes = bytes + sizeof(Node); // total size of a new node + memory block
+    size_t class = sizeClass(node->size);
 
-    if (bytes < 1) return NULL;
+    FREE_LINKS(node)->prevFree = NULL;
+    FREE_LINKS(node)->nextFree = arena->freeLists[class];
 
-    pthread_mutex_lock(&lock);
-    /* lastUsed is used for readability but isn't necessary as firstBlock could just be continually updated for it to
-     * also work as intended. */
-    Node *node = lastUsed->prev;
+    if (arena->freeLists[class] != NULL) FREE_LINKS(arena->freeLists[class])->prevFree = node;
+    arena->freeLists[class] = node;
+}
 
-    do
-    {
-        node = node->next; // Increment through the list
-        if (node->free == false || node->size < bytes) continue;  // Don't use non free nodes or too small nodes
+/**
+ * Unlinks a node from the free list of its size class.
+ *
+ * @param arena - arena the node is in
+ * @param node - free node to be removed
+ */
+static void segregatedRemove(Arena *arena, Node *node)
+{
+    FreeLinks *links = FREE_LINKS(node);
 
-        lastUsed = node; // Update last accessed node
+    if (links->prevFree != NULL) FREE_LINKS(links->prevFree)->nextFree = links->nextFree;
+    else arena->freeLists[sizeClass(node->size)] = links->nextFree;
 
-        /* If block found has exact size or is exact size of memory + size of node allocate */
-        if (node->size <= totalBytes)
-        {
-            node->free = false;
-            pthread_mutex_unlock(&lock);
-            return (void *)((void *) (node) + sizeof(Node));
-        }
+    if (links->nextFree != NULL) FREE_LINKS(links->nextFree)->prevFree = links->prevFree;
+}
+
+/**
+ * Orders free nodes in the best fit tree by size, using the address to order nodes of the same size.
+ *
+ * @param a - first node
+ * @param b - second node
+ * @return - true if a comes before b
+ */
+static bool_type treeBefore(Node *a, Node *b)
+{
+    if (a->size != b->size) return a->size < b->size;
+    return a < b;
+}
 
-        pthread_mutex_unlock(&lock);
-        return (void *)((void *)(freeNode(node, bytes)) + sizeof(Node));
+/**
+ * Checks the colour of a node in the best fit tree, where missing children count as black.
+ *
+ * @param node - node to be checked/NULL
+ * @return - true if the node is red
+ */
+static bool_type treeRed(Node *node)
+{
+    return node != NULL && TREE_LINKS(node)->red == true;
+}
 
-    }while(node->next != lastUsed); // End of loop met
+/**
+ * Puts a node in the place of a child of parent, or at the root of the tree if there is no parent.
+ *
+ * @param arena - arena the node is in
+ * @param parent - parent of the child being replaced/NULL
+ * @param oldChild - child being replaced
+ * @param newChild - node taking its place/NULL
+ */
+static void treeReplace(Arena *arena, Node *parent, Node *oldChild, Node *newChild)
+{
+    if (parent == NULL) arena->treeRoot = newChild;
+    else TREE_LINKS(parent)->child[TREE_LINKS(parent)->child[1] == oldChild] = newChild;
 
-    pthread_mutex_unlock(&lock);
-    return NULL;
+    if (newChild != NULL) TREE_LINKS(newChild)->parent = parent;
 }
 
 /**
- * This algorithm allocates memory by looping over the entire list and finding the smallest sized node possible that
- * will fit the requested amount of bytes. This is saved in a node variable and is updated when a better option is
- * found. At the end of the loop the node is then either used if a new node can't be created or a new node is created
- * using the freeNode function. This function also locks the current thread when accessing the main pool of memory and
- * unlocks it when returning the memory address.
+ * Rotates the tree around a node, moving the node down to the given side and its child from the other side up.
  *
- * @param bytes - requested bytes to be allocated
- * @return - void memory pointer/NULL if can't be allocated
+ * @param arena - arena the node is in
+ * @param node - node to be rotated around
+ * @param side - 0 to rotate left/1 to rotate right
  */
-void *bestFit(size_t bytes)
+static void treeRotate(Arena *arena, Node *node, int side)
 {
-    size_t totalBytes = bytes + sizeof(Node); // total size of a new node + memory block
-    Node *bestNode = NULL;
+    TreeLinks *links = TREE_LINKS(node);
+    Node *up = links->child[!side];
+    TreeLinks *upLinks = TREE_LINKS(up);
 
-    if (bytes < 1) return NULL;
+    links->child[!side] = upLinks->child[side];
+    if (upLinks->child[side] != NULL) TREE_LINKS(upLinks->child[side])->parent = node;
 
-    pthread_mutex_lock(&lock);
-    Node *node = firstBlock->prev;
+    treeReplace(arena, links->parent, node, up);
+    upLinks->child[side] = node;
+    links->parent = up;
+}
 
-    do
+/**
+ * Adds a free node to the best fit tree, then recolours and rotates the tree so that it stays balanced.
+ *
+ * @param arena - arena the node is in
+ * @param node - free node to be added
+ */
+static void treeInsert(Arena *arena, Node *node)
+{
+    Node *parent = NULL;
+    int side = 0;
+
+    for (Node *current = arena->treeRoot; current != NULL; current = TREE_LINKS(current)->child[side])
     {
-        node = node->next; // Increment through the list
-        if (node->free == false || node->size < bytes) continue;  // Don't use non free nodes or too small nodes
+        parent = current;
+        side = treeBefore(current, node);
+    }
 
-        if (node->size == bytes)
-        {
-            node->free = false;
-            pthread_mutex_unlock(&lock);
-            return (void *)((void *) (node) + sizeof(Node));
-        }
-        if (bestNode == NULL || node->size < bestNode->size) bestNode = node;
+    TREE_LINKS(node)->child[0] = TREE_LINKS(node)->child[1] = NULL;
+    TREE_LINKS(node)->parent = parent;
+    TREE_LINKS(node)->red = true;
 
-    }while(node->next != firstBlock);
+    if (parent == NULL) arena->treeRoot = node;
+    else TREE_LINKS(parent)->child[side] = node;
 
-    if (bestNode != NULL)
+    /* A red parent is never the root, so the grandparent always exists */
+    while (treeRed(parent = TREE_LINKS(node)->parent))
     {
-        bestNode->free = false; // If no new node can be created, use whole node
-        if (bestNode->size > totalBytes) bestNode = freeNode(bestNode, bytes); // If new node can be created
+        Node *grandparent = TREE_LINKS(parent)->parent;
+        side = TREE_LINKS(grandparent)->child[1] == parent;
+        Node *uncle = TREE_LINKS(grandparent)->child[!side];
+
+        if (treeRed(uncle))
+        {
+            TREE_LINKS(parent)->red = TREE_LINKS(uncle)->red = false;
+            TREE_LINKS(grandparent)->red = true;
+            node = grandparent;
+            continue;
+        }
 
-        pthread_mutex_unlock(&lock);
-        return ((void *)((void *)(bestNode) + sizeof(Node))); // End of loop met
+        if (node == TREE_LINKS(parent)->child[!side]) // Inner child is rotated to the outside first
+        {
+            treeRotate(arena, parent, side);
+            node = parent;
+            parent = TREE_LINKS(node)->parent;
+        }
+        TREE_LINKS(parent)->red = false;
+        TREE_LINKS(grandparent)->red = true;
+        treeRotate(arena, grandparent, !side);
     }
-    pthread_mutex_unlock(&lock);
-    return NULL;
+    TREE_LINKS(arena->treeRoot)->red = false;
 }
 
 /**
- * This algorithm allocates memory by looping over the entire list and finding the biggest sized node possible that will
- * fit the requested amount of bytes. This is saved in a node variable and is updated when a bigger option is found. At
- * the end of the loop the node is then either used if a new node can't be created or a new node is created using the
- * freeNode function. This function also locks the current thread when accessing the main pool of memory and unlocks it
- * when returning the memory address.
+ * Takes a free node out of the best fit tree. A node with two children is swapped for the smallest node after it, and
+ * if a black node is lost the tree is recoloured and rotated so that it stays balanced.
  *
- * @param bytes - requested bytes to be allocated
- * @return - void memory pointer/NULL if can't be allocated
+ * @param arena - arena the node is in
+ * @param node - free node to be removed
  */
-void *worstFit(size_t bytes)
+static void treeRemove(Arena *arena, Node *node)
 {
-    size_t totalBytes = bytes + sizeof(Node); // total size of a new node + memory block
-    Node *worstNode = NULL;
+    TreeLinks *links = TREE_LINKS(node);
+    Node *child, *parent;
+    bool_type red;
 
-    if (bytes < 1) return NULL;
-
-    pthread_mutex_lock(&lock);
-    Node *node = firstBlock->prev;
-
-    do
+    if (links->child[0] != NULL && links->child[1] != NULL)
     {
-        node = node->next; // Increment through the list
+        Node *next = links->child[1];
+        while (TREE_LINKS(next)->child[0] != NULL) next = TREE_LINKS(next)->child[0];
 
-        if (node->free == false || node->size < bytes) continue;  // Don't use non free nodes or too small nodes
+        child = TREE_LINKS(next)->child[1];
+        parent = TREE_LINKS(next)->parent;
+        red = TREE_LINKS(next)->red;
 
-        if (node->size >= bytes)
+        if (parent == node) parent = next; // Next keeps its right child
+        else
         {
-            if (worstNode == NULL || node->size > worstNode->size) worstNode = node; // Updating worst node variable
+            treeReplace(arena, parent, next, child);
+            TREE_LINKS(next)->child[1] = links->child[1];
+            TREE_LINKS(links->child[1])->parent = next;
         }
 
-    }while(node->next != firstBlock);
+        treeReplace(arena, links->parent, node, next);
+        TREE_LINKS(next)->child[0] = links->child[0];
+        TREE_LINKS(links->child[0])->parent = next;
+        TREE_LINKS(next)->red = links->red;
+    }
+    else
+    {
+        child = links->child[links->child[0] == NULL];
+        parent = links->parent;
+        red = links->red;
+        treeReplace(arena, parent, node, child);
+    }
+    if (red == true) return;
 
-    if (worstNode != NULL)
+    /* Child is missing a black node on its path, which is moved up the tree until it can be made up for */
+    while (child != arena->treeRoot && treeRed(child) == false)
     {
-        worstNode->free = false;
-        if (worstNode->size > totalBytes) worstNode = freeNode(worstNode, bytes);
+        int side = TREE_LINKS(parent)->child[1] == child;
+        Node *sibling = TREE_LINKS(parent)->child[!side];
+
+        if (treeRed(sibling))
+        {
+            TREE_LINKS(sibling)->red = false;
+            TREE_LINKS(parent)->red = true;
+            treeRotate(arena, parent, side);
+            sibling = TREE_LINKS(parent)->child[!side];
+        }
 
-        pthread_mutex_unlock(&lock);
-        return (void *)((void *)(worstNode) + sizeof(Node)); // End of loop met
+        if (!treeRed(TREE_LINKS(sibling)->child[0]) && !treeRed(TREE_LINKS(sibling)->child[1]))
+        {
+            TREE_LINKS(sibling)->red = true;
+            child = parent;
+            parent = TREE_LINKS(child)->parent;
+            continue;
+        }
+
+        if (!treeRed(TREE_LINKS(sibling)->child[!side]))
+        {
+            TREE_LINKS(TREE_LINKS(sibling)->child[side])->red = false;
+            TREE_LINKS(sibling)->red = true;
+            treeRotate(arena, sibling, !side);
+            sibling = TREE_LINKS(parent)->child[!side];
+        }
+        TREE_LINKS(sibling)->red = TREE_LINKS(parent)->red;
+        TREE_LINKS(parent)->red = false;
+        TREE_LINKS(TREE_LINKS(sibling)->child[!side])->red = false;
+        treeRotate(arena, parent, side);
+        child = arena->treeRoot;
     }
-    pthread_mutex_unlock(&lock);
-    return NULL;
+    if (child != NULL) TREE_LINKS(child)->red = false;
 }
 
 /**
- * Initialises first node which is a hole that takes up the entire heap. The node structure is then given information
- * about it's self. Null checks are conducted to make sure that memory allocation has worked.
- * Once the first node is made the first and last pointers are initialised.
- * Also, using the algorithm parameter, the function pointer for allocate is created based on which algorithm is
- * passed - if an invalid one is chosen, first fit is chosen by default.
+ * Joins two pairing heaps by making the root of the smaller one the first child of the bigger one.
  *
- * @param memory - pointer to heap
- * @param size - size of heap in bytes
- * @param algorithm - the algorithm to be used
+ * @param a - root of the first heap/NULL
+ * @param b - root of the second heap/NULL
+ * @return - root of the joined heap
  */
-void initialise(void *memory , size_t size, char *algorithm)
+static Node *heapMeld(Node *a, Node *b)
 {
-    if (algorithm == NULL) allocate = &firstFit; // Check for NULL being passed in, and default to firstFit
-    else if (!strcmp(algorithm, "BestFit")) allocate = &bestFit;
-    else if (!strcmp(algorithm, "WorstFit")) allocate = &worstFit;
-    else if (!strcmp(algorithm, "NextFit")) allocate = &nextFit;
-    else allocate = &firstFit; // If anything else, default to firstFit.
-
-    Node *node = (Node *)(memory); // Assign struct to start of heap
-
-    if (size == 0 || node == NULL)
+    if (a == NULL || (b != NULL && a->size < b->size))
     {
-        fprintf(stderr, "Error: Unable to allocate memory in initialise().\n");
-        exit(EXIT_FAILURE);
+        Node *swap = a;
+        a = b;
+        b = swap;
     }
+    if (a == NULL) return NULL;
 
-    node->free = true;
-    node->size = size - sizeof(Node); // Initialises size to not include the size of the struct
-    node->next = node;
-    node->prev = node;
-
-    firstBlock = lastUsed = node; // Sets up lastUsed in all cases for readability
+    HeapLinks *links = HEAP_LINKS(a);
+    links->sibling = links->prev = NULL;
 
-    lock = PTHREAD_MUTEX_INITIALIZER; // Initialise the lock with default behaviour
+    if (b != NULL)
+    {
+        HEAP_LINKS(b)->sibling = links->child;
+        HEAP_LINKS(b)->prev = a;
+        if (links->child != NULL) HEAP_LINKS(links->child)->prev = b;
+        links->child = b;
+    }
+    return a;
 }
 
 /**
- * Deallocate memory by setting the node->free to true so that it can be used in allocating. If there is a free node
- * before or after it, said node, is disconnected and the current node is then grown into it creating one big node.
- * Also, if nodes are being coalesced the lastUsed node is preserved if its node is unlinked.
+ * Joins a list of sibling heaps into one heap. Siblings are first joined in pairs from left to right, then the pairs
+ * are joined from right to left, which is what keeps the pairing heap's operations logarithmic.
  *
- * @param memory - the memory pointer to be unallocated
+ * @param first - first sibling/NULL
+ * @return - root of the joined heap
  */
-void deallocate(void *memory)
+static Node *heapMergePairs(Node *first)
 {
-    Node *node = (Node *)(memory); // Get node pointer from memory pointer
-    if(node == NULL) return; // Make sure that the input is a valid pointer
-    node --; // Moves back one node struct to the actual node struct
+    Node *pairs = NULL; // Joined pairs, chained through their sibling link in reverse order
+    Node *root = NULL;
 
-    pthread_mutex_lock(&lock);
-
-    Node *prevNode = node->prev;
-    Node *nextNode = node->next;
+    while (first != NULL)
+    {
+        Node *second = HEAP_LINKS(first)->sibling;
+        Node *next = (second == NULL) ? NULL : HEAP_LINKS(second)->sibling;
+        Node *pair = heapMeld(first, second);
 
-    node->free = true;
+        HEAP_LINKS(pair)->sibling = pairs;
+        pairs = pair;
+        first = next;
+    }
 
-    /* If next node can be coalesced and prevent wrap coalescing (front & end joining) */
-    if(nextNode != node && nextNode->free == true && nextNode != firstBlock)
+    while (pairs != NULL)
     {
-        /* If in next fit and coalesced node is last used, update last used to preserve */
-        if (lastUsed == nextNode) lastUsed = node;
+        Node *next = HEAP_LINKS(pairs)->sibling;
+        root = heapMeld(root, pairs);
+        pairs = next;
+    }
+    return root;
+}
 
-        node->next = nextNode->next;
-        node->size += nextNode->size + sizeof(Node); // Increase main node size
+/**
+ * Adds a free node to the worst fit heap.
+ *
+ * @param arena - arena the node is in
+ * @param node - free node to be added
+ */
+static void heapInsert(Arena *arena, Node *node)
+{
+    HEAP_LINKS(node)->child = NULL;
+    arena->heapRoot = heapMeld(arena->heapRoot, node);
+}
 
-        if (nextNode->next != node) nextNode->next->prev = node;
-    }
+/**
+ * Takes a free node out of the worst fit heap. Its children are joined into one heap, which replaces the root if the
+ * node was the root or is otherwise joined back with the root after the node is cut out of its parent's children.
+ *
+ * @param arena - arena the node is in
+ * @param node - free node to be removed
+ */
+static void heapRemove(Arena *arena, Node *node)
+{
+    HeapLinks *links = HEAP_LINKS(node);
+    Node *children = heapMergePairs(links->child);
 
-    /* If previous node can be coalesced and prevent wrap coalescing (front & end joining) */
-    if(prevNode != node && prevNode->free == true && node != firstBlock)
+    if (node == arena->heapRoot)
     {
-        /* If in next fit and coalesced node is last used, update last used to preserve */
-        if (lastUsed == node) lastUsed = prevNode;
+        arena->heapRoot = children;
+        return;
+    }
 
-        prevNode->next = node->next; // Un-link old node
-        prevNode->size += node->size + sizeof(Node); // Increase main node size
+    if (HEAP_LINKS(links->prev)->child == node) HEAP_LINKS(links->prev)->child = links->sibling;
+    else HEAP_LINKS(links->prev)->sibling = links->sibling;
+    if (links->sibling != NULL) HEAP_LINKS(links->sibling)->prev = links->prev;
 
-        if (node->next != node) node->next->prev = prevNode;
-    }
-    pthread_mutex_unlock(&lock);
+    arena->heapRoot = heapMeld(arena->heapRoot, children);
 }
 
 /**
- *  Prints out all node details in a readable format
+ * Maps a size to its TLSF lists. The first level is the power of two at or below the size and the second level splits
+ * that power of two linearly, with sizes below TLSF_SL_COUNT all kept in the first level 0.
+ *
+ * @param size - size to be mapped
+ * @param first - set to the first level
+ * @param second - set to the second level
  */
-void memoryManager_printf()
+static void tlsfMapping(size_t size, size_t *first, size_t *second)
 {
-    printf("\n");
-    int blkCounter = 1; // Block counter
-    for (Node *node = firstBlock; node != NULL; node = node->next)
+    if (size < TLSF_SL_COUNT)
     {
-        // If at end don't print comma
-        printf("Block : %d ",blkCounter++);
-        printf(node->next == firstBlock ? "(Free : %d, Size : %d, Node Size : %d, Memory : %p)\n":"(Free : %d, Size : %d, Node Size : %d, Memory : %p),\n",
-               node->free, node->size, sizeof(Node), ((void *)(node) + sizeof(Node)));
-        if(node->next == firstBlock) break;
+        *first = 0;
+        *second = size;
+        return;
+    }
+
+    size_t power = SIZE_CLASSES - 1 - __builtin_clzl(size);
+    *first = power - TLSF_SL_LOG2 + 1;
+    *second = (size >> (power - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+}
+
+/**
+ * Pushes a free node onto the front of its TLSF list and marks the list as non empty in both bitmaps.
+ *
+ * @param arena - arena the node is in
+ * @param node - free node to be added
+ */
+static void tlsfInsert(Arena *arena, Node *node)
+{
+    size_t first, second;
+    tlsfMapping(node->size, &first, &second);
+
+    FREE_LINKS(node)->prevFree = NULL;
+    FREE_LINKS(node)->nextFree = arena->tlsfLists[first][second];
+
+    if (arena->tlsfLists[first][second] != NULL) FREE_LINKS(arena->tlsfLists[first][second])->prevFree = node;
+    arena->tlsfLists[first][second] = node;
+
+    arena->tlsfFirstMap |= (size_t)(1) << first;
+    arena->tlsfSecondMap[first] |= 1U << second;
+}
+
+/**
+ * Unlinks a node from its TLSF list, clearing the list's bits if it is left empty.
+ *
+ * @param arena - arena the node is in
+ * @param node - free node to be removed
+ */
+static void tlsfRemove(Arena *arena, Node *node)
+{
+    FreeLinks *links = FREE_LINKS(node);
+    size_t first, second;
+    tlsfMapping(node->size, &first, &second);
+
+    if (links->prevFree != NULL) FREE_LINKS(links->prevFree)->nextFree = links->nextFree;
+    else arena->tlsfLists[first][second] = links->nextFree;
+
+    if (links->nextFree != NULL) FREE_LINKS(links->nextFree)->prevFree = links->prevFree;
+
+    if (arena->tlsfLists[first][second] == NULL)
+    {
+        arena->tlsfSecondMap[first] &= ~(1U << second);
+        if (arena->tlsfSecondMap[first] == 0) arena->tlsfFirstMap &= ~((size_t)(1) << first);
+    }
+}
+
+/**
+ * Tells the processor that the calling thread is spinning, so that it can save power and let a sibling thread run.
+ */
+static void spinPause()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Sets up the lock of an arena for the given policy.
+ *
+ * @param lock - lock to be set up
+ * @param policy - one of the LOCK_ policies
+ */
+static void lockInit(ArenaLock *lock, int policy)
+{
+    lock->policy = policy;
+    lock->word = lock->ticket = lock->serving = 0;
+    pthread_mutex_init(&lock->mutex, NULL); // Initialise the lock with default behaviour
+
+    if (policy == LOCK_SHARED)
+    {
+        pthread_rwlockattr_t attributes;
+
+        /* Otherwise a steady stream of region locked operations could keep a whole list operation waiting forever */
+        pthread_rwlockattr_init(&attributes);
+        pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+        pthread_rwlock_init(&lock->rwlock, &attributes);
+        pthread_rwlockattr_destroy(&attributes);
+    }
+}
+
+/**
+ * Tears down the lock of an arena once the arena is no longer used.
+ *
+ * @param lock - lock to be torn down
+ */
+static void lockDestroy(ArenaLock *lock)
+{
+    pthread_mutex_destroy(&lock->mutex);
+    if (lock->policy == LOCK_SHARED) pthread_rwlock_destroy(&lock->rwlock);
+}
+
+/**
+ * Takes the lock of an arena if nobody holds it, without waiting.
+ *
+ * @param lock - lock to be taken
+ * @return - true if the lock was taken/false if it is held
+ */
+static bool_type lockTry(ArenaLock *lock)
+{
+    unsigned int expected = 0;
+
+    switch (lock->policy)
+    {
+        case LOCK_NONE:
+            return true;
+        case LOCK_SPIN:
+            if (__atomic_load_n(&lock->word, __ATOMIC_RELAXED) != 0) return false;
+            return (__atomic_exchange_n(&lock->word, 1, __ATOMIC_ACQUIRE) == 0) ? true : false;
+        case LOCK_TICKET:
+            expected = __atomic_load_n(&lock->serving, __ATOMIC_ACQUIRE); // Only free if the next ticket is served
+            return __atomic_compare_exchange_n(&lock->ticket, &expected, expected + 1, false, __ATOMIC_ACQUIRE,
+                                               __ATOMIC_RELAXED) ? true : false;
+        case LOCK_FUTEX:
+            return __atomic_compare_exchange_n(&lock->word, &expected, 1, false, __ATOMIC_ACQUIRE,
+                                               __ATOMIC_RELAXED) ? true : false;
+        case LOCK_SHARED:
+            return (pthread_rwlock_trywrlock(&lock->rwlock) == 0) ? true : false;
+        default:
+            return (pthread_mutex_trylock(&lock->mutex) == 0) ? true : false;
+    }
+}
+
+/**
+ * Takes the lock of an arena, waiting for it if it is held. The spinlock reads the lock until it looks free before
+ * trying to take it, so waiting threads don't fight over its cache line, and waits twice as long after each failed
+ * try. The ticket lock serves threads in order. Both yield the processor once they have spun for a while, as the
+ * thread holding the lock may not be running. The futex mutex spins for a while in case the lock is about to be
+ * let go, then marks it as having sleepers and sleeps in the kernel until woken.
+ *
+ * @param lock - lock to be taken
+ */
+static void lockAcquire(ArenaLock *lock)
+{
+    unsigned int state = 0;
+
+    switch (lock->policy)
+    {
+        case LOCK_NONE:
+            return;
+        case LOCK_SPIN:
+            for (unsigned int backoff = 1; __atomic_exchange_n(&lock->word, 1, __ATOMIC_ACQUIRE) != 0;)
+            {
+                while (__atomic_load_n(&lock->word, __ATOMIC_RELAXED) != 0)
+                {
+                    if (backoff >= SPIN_BACKOFF_LIMIT) sched_yield(); // The holder may be waiting for the processor
+                    else for (unsigned int i = 0; i < backoff; i++) spinPause();
+                    if (backoff < SPIN_BACKOFF_LIMIT) backoff *= 2;
+                }
+            }
+            return;
+        case LOCK_TICKET:
+        {
+            unsigned int ticket = __atomic_fetch_add(&lock->ticket, 1, __ATOMIC_RELAXED);
+            unsigned int serving;
+
+            /* Only the thread next in line spins, the others can't be served before it so they yield */
+            for (unsigned int waited = 0; (serving = __atomic_load_n(&lock->serving, __ATOMIC_ACQUIRE)) != ticket;)
+            {
+                if (ticket - serving > 1 || waited >= SPIN_BACKOFF_LIMIT) sched_yield();
+                else for (unsigned int i = 0; i < 8; i++, waited++) spinPause();
+            }
+            return;
+        }
+        case LOCK_FUTEX:
+            for (int i = 0; i < FUTEX_SPINS; i++)
+            {
+                state = 0;
+                if (__atomic_compare_exchange_n(&lock->word, &state, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                {
+                    return;
+                }
+                if (state == 2) break; // Others are already asleep, so join them
+                spinPause();
+            }
+
+            while (__atomic_exchange_n(&lock->word, 2, __ATOMIC_ACQUIRE) != 0)
+            {
+                syscall(SYS_futex, &lock->word, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+            }
+            return;
+        case LOCK_SHARED:
+            pthread_rwlock_wrlock(&lock->rwlock);
+            return;
+        default:
+            pthread_mutex_lock(&lock->mutex);
+    }
+}
+
+/**
+ * Takes the shared side of an arena's reader-writer lock, which any number of region locked operations can hold at
+ * once while keeping out anything that works on the arena's whole list. Lets go of it with lockRelease.
+ *
+ * @param lock - lock to be taken, whose policy must be LOCK_SHARED
+ */
+static void lockShared(ArenaLock *lock)
+{
+    pthread_rwlock_rdlock(&lock->rwlock);
+}
+
+/**
+ * Lets go of the lock of an arena, waking a sleeper if it is a futex mutex that has any.
+ *
+ * @param lock - lock to be let go
+ */
+static void lockRelease(ArenaLock *lock)
+{
+    switch (lock->policy)
+    {
+        case LOCK_NONE:
+            return;
+        case LOCK_SPIN:
+            __atomic_store_n(&lock->word, 0, __ATOMIC_RELEASE);
+            return;
+        case LOCK_TICKET:
+            __atomic_store_n(&lock->serving, lock->serving + 1, __ATOMIC_RELEASE); // Only the holder writes it
+            return;
+        case LOCK_FUTEX:
+            if (__atomic_exchange_n(&lock->word, 0, __ATOMIC_RELEASE) == 2)
+            {
+                syscall(SYS_futex, &lock->word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+            }
+            return;
+        case LOCK_SHARED:
+            pthread_rwlock_unlock(&lock->rwlock); // Whichever side is held
+            return;
+        default:
+            pthread_mutex_unlock(&lock->mutex);
+    }
+}
+
+/**
+ * Finds the arena the calling thread allocates from, handing threads out to the arenas round-robin on first use.
+ *
+ * @param manager - heap the arena is in
+ * @return - index of the thread's arena
+ */
+static size_t homeArena(MemoryManager *manager)
+{
+    size_t index = (size_t)(pthread_getspecific(manager->arenaKey)); // Stored plus one so that NULL means unassigned
+
+    if (index == 0 || index > manager->arenaCount)
+    {
+        index = __sync_fetch_and_add(&manager->nextArena, 1) % manager->arenaCount + 1;
+        pthread_setspecific(manager->arenaKey, (void *)(index));
+    }
+    return index - 1;
+}
+
+/**
+ * Finds the arena a node belongs to from its offset into the heap.
+ *
+ * @param manager - heap the node is in
+ * @param node - node to be looked up
+ * @return - the node's arena
+ */
+static Arena *arenaOf(MemoryManager *manager, Node *node)
+{
+    /* Segments are only ever added, and each is filled in before it is published */
+    if (manager->growable == true)
+    {
+        for (Segment *segment = __atomic_load_n(&manager->segments, __ATOMIC_ACQUIRE); segment != NULL;
+             segment = segment->next)
+        {
+            if ((void *)(node) > (void *)(segment) && (void *)(node) < (void *)(segment) + segment->size)
+            {
+                return segment->arena;
+            }
+        }
+    }
+
+    size_t index = (size_t)((void *)(node) - (void *)(manager->arenas[0].firstBlock)) / manager->arenaSpan;
+
+    if (index >= manager->arenaCount) index = manager->arenaCount - 1; // The last arena also holds what is left over
+    return &manager->arenas[index];
+}
+
+/**
+ * Finds where the slice of the heap an arena was given starts, which is where its first node was put.
+ *
+ * @param manager - heap the arena is in
+ * @param index - index of the arena
+ * @return - start of the arena's slice
+ */
+static void *arenaStart(MemoryManager *manager, size_t index)
+{
+    return (void *)(manager->arenas[0].firstBlock) + index * manager->arenaSpan;
+}
+
+/**
+ * Finds where the slice of the heap an arena was given ends.
+ *
+ * @param manager - heap the arena is in
+ * @param index - index of the arena
+ * @return - end of the arena's slice
+ */
+static void *arenaEnd(MemoryManager *manager, size_t index)
+{
+    return (index + 1 == manager->arenaCount) ? manager->arenaEnd : arenaStart(manager, index + 1);
+}
+
+/**
+ * Checks whether a node runs on past the end of its arena's slice into the arenas after it, which only blocks handed
+ * out by spanFit do.
+ *
+ * @param arena - arena the node is in
+ * @param node - node to be checked
+ * @return - true if the node spans arenas/false otherwise
+ */
+static bool_type spansArenas(Arena *arena, Node *node)
+{
+    MemoryManager *manager = arena->manager;
+    size_t index = (size_t)(arena - manager->arenas);
+
+    if (index + 1 >= manager->arenaCount) return false; // Nothing comes after the last arena
+    if ((void *)(node) < arenaStart(manager, index) || (void *)(node) >= arenaEnd(manager, index)) return false;
+    return ((void *)(node) + sizeof(Node) + node->size > arenaEnd(manager, index)) ? true : false;
+}
+
+/**
+ * Puts a node in the place of another in a circular list, taking over its links.
+ *
+ * @param old - node to be replaced
+ * @param node - node to take its place
+ */
+static void replaceNode(Node *old, Node *node)
+{
+    node->next = (old->next == old) ? node : old->next;
+    node->prev = (old->prev == old) ? node : old->prev;
+    node->next->prev = node;
+    node->prev->next = node;
+}
+
+/**
+ * Allocates a chunk from the small block tier. The bitmap of the request's class is scanned from the word the last
+ * chunk was found in, skipping full words, and the first clear bit found with a count trailing zeros instruction is set
+ * with a compare and swap so that no lock is needed.
+ *
+ * @param manager - heap to allocate from
+ * @param bytes - requested bytes, at most SMALL_MAXIMUM
+ * @return - void memory pointer/NULL if the class is full
+ */
+static void *smallAllocate(MemoryManager *manager, size_t bytes)
+{
+    size_t class = (bytes <= SMALL_GRANULE) ? 0 : SIZE_CLASSES - __builtin_clzl(bytes - 1) - __builtin_ctz(SMALL_GRANULE);
+    SmallClass *small = &manager->smallClasses[class];
+    size_t hint = __atomic_load_n(&small->hint, __ATOMIC_RELAXED);
+
+    for (size_t i = 0; i < small->words; i++)
+    {
+        size_t word = (hint + i) % small->words;
+        unsigned long long bits = __atomic_load_n(&small->bitmap[word], __ATOMIC_RELAXED);
+
+        while (bits != ~0ULL)
+        {
+            size_t bit = __builtin_ctzll(~bits);
+            if (__atomic_compare_exchange_n(&small->bitmap[word], &bits, bits | (1ULL << bit), true, __ATOMIC_ACQUIRE,
+                                            __ATOMIC_RELAXED))
+            {
+                if (word != hint) __atomic_store_n(&small->hint, word, __ATOMIC_RELAXED);
+                return small->start + (word * 64 + bit) * small->chunkSize;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Finds the class of the small block tier that memory was allocated from.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointer to be looked up
+ * @return - the chunk's class/NULL if the memory belongs to a node
+ */
+static SmallClass *smallClassOf(MemoryManager *manager, void *memory)
+{
+    if (manager->smallBlocks == false || memory < manager->smallStart || memory >= manager->smallEnd) return NULL;
+
+    for (size_t class = 0; class < SMALL_CLASSES; class++)
+    {
+        SmallClass *small = &manager->smallClasses[class];
+        if (memory >= small->start && memory < small->end) return small;
+    }
+    return NULL;
+}
+
+/**
+ * Frees a chunk of the small block tier by clearing its bit, if the memory is in the tier's region.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointer to be unallocated
+ * @return - true if the memory was a chunk/false if it belongs to a node
+ */
+static bool_type smallFree(MemoryManager *manager, void *memory)
+{
+    SmallClass *small = smallClassOf(manager, memory);
+    if (small == NULL) return false;
+
+    size_t chunk = (size_t)(memory - small->start) / small->chunkSize;
+    __atomic_fetch_and(&small->bitmap[chunk / 64], ~(1ULL << (chunk % 64)), __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * Sets aside a region at the end of a heap for the small block tier, giving each class an equal share of it as a
+ * whole number of bitmap words. Classes are placed largest first so that every chunk stays aligned to its size.
+ *
+ * @param manager - heap the tier is for
+ * @param memory - pointer to heap
+ * @param size - size of heap in bytes
+ * @return - bytes left for the arenas, which is all of them if the heap is too small for the tier
+ */
+static size_t smallSetup(MemoryManager *manager, void *memory, size_t size)
+{
+    size_t share = size / SMALL_SHARE / SMALL_CLASSES;
+    size_t words[SMALL_CLASSES];
+    size_t totalWords = 0;
+    size_t region = 0;
+
+    for (size_t class = 0; class < SMALL_CLASSES; class++)
+    {
+        words[class] = share / ((size_t)(SMALL_GRANULE) << class) / 64;
+        if (words[class] == 0) return size; // Not even one word of the largest chunks fits
+
+        totalWords += words[class];
+        region += words[class] * 64 * ((size_t)(SMALL_GRANULE) << class);
+    }
+
+    unsigned long long *bitmap = calloc(totalWords, sizeof(unsigned long long));
+    if (bitmap == NULL) return size;
+
+    size_t offset = (size - region) & ~(size_t)(SMALL_MAXIMUM - 1);
+    manager->smallBlocks = true;
+    manager->smallStart = memory + offset;
+
+    for (size_t class = SMALL_CLASSES; class-- > 0;)
+    {
+        SmallClass *small = &manager->smallClasses[class];
+
+        small->chunkSize = (size_t)(SMALL_GRANULE) << class;
+        small->words = words[class];
+        small->bitmap = bitmap;
+        small->start = memory + offset;
+        small->end = small->start + small->words * 64 * small->chunkSize;
+
+        bitmap += small->words;
+        offset += small->words * 64 * small->chunkSize;
+    }
+    manager->smallEnd = memory + offset;
+
+    return manager->smallStart - memory;
+}
+
+/**
+ * Grows a full arena by mapping a new segment, which is twice the size of the last one the heap mapped and at least
+ * twice the request, so that whatever rounding the algorithm applies it finds room. The segment becomes a free node at
+ * the end of the arena's list that is never coalesced with the node before it, as the two aren't next to each other in
+ * memory. The caller must hold the lock.
+ *
+ * @param arena - arena to be grown
+ * @param bytes - requested bytes that didn't fit
+ * @return - true if the arena was grown/false if the heap isn't growable or no memory could be mapped
+ */
+static bool_type growArena(Arena *arena, size_t bytes)
+{
+    MemoryManager *manager = arena->manager;
+    Segment *newest = __atomic_load_n(&manager->segments, __ATOMIC_ACQUIRE);
+    size_t page = (size_t)(sysconf(_SC_PAGESIZE));
+    size_t size = (newest == NULL) ? SEGMENT_MINIMUM : newest->size * 2;
+
+    if (manager->growable == false) return false;
+    if (bytes > (~(size_t)(0) - sizeof(Segment) - page) / 2 - sizeof(Node)) return false; // Would overflow
+
+    if (size > SEGMENT_MAXIMUM) size = SEGMENT_MAXIMUM;
+    if (size < sizeof(Segment) + 2 * (bytes + sizeof(Node))) size = sizeof(Segment) + 2 * (bytes + sizeof(Node));
+    size = (size + page - 1) & ~(page - 1);
+
+    Segment *segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (segment == MAP_FAILED) return false;
+
+    segment->arena = arena;
+    segment->size = size;
+
+    Node *node = (Node *)((void *)(segment) + sizeof(Segment));
+    Node *last = arena->firstBlock->prev;
+
+    node->free = true;
+    node->flags = NODE_SEGMENT | NODE_ZEROED; // Fresh mappings are always zero
+    node->size = size - sizeof(Segment) - sizeof(Node);
+    node->prev = last;
+    node->next = arena->firstBlock;
+    last->next = node;
+    arena->firstBlock->prev = node;
+    if (manager->indexInsert != NULL) manager->indexInsert(arena, node);
+
+    /* Other arenas may be growing at the same time, and arenaOf reads the list without a lock */
+    do segment->next = __atomic_load_n(&manager->segments, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&manager->segments, &segment->next, segment, false, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+    return true;
+}
+
+/**
+ * Support function that adds a mapped block to the list of its heap. The caller must hold the map lock.
+ *
+ * @param manager - heap the block belongs to
+ * @param node - node at the start of the mapping
+ */
+static void linkMapped(MemoryManager *manager, Node *node)
+{
+    node->prev = NULL;
+    node->next = manager->mappedBlocks;
+    if (node->next != NULL) node->next->prev = node;
+    manager->mappedBlocks = node;
+}
+
+/**
+ * Support function that takes a mapped block out of the list of its heap. The caller must hold the map lock.
+ *
+ * @param manager - heap the block belongs to
+ * @param node - node at the start of the mapping
+ */
+static void unlinkMapped(MemoryManager *manager, Node *node)
+{
+    if (node->prev != NULL) node->prev->next = node->next;
+    else manager->mappedBlocks = node->next;
+    if (node->next != NULL) node->next->prev = node->prev;
+}
+
+/**
+ * Allocates a block in a mapping of its own, so that a large request doesn't split up the lists of the arenas and its
+ * memory goes straight back to the operating system once it is deallocated. The mapping starts with a node marked as
+ * mapped so that deallocation and reallocation can tell it apart.
+ *
+ * @param manager - heap the block belongs to
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be mapped
+ */
+static void *mapBlock(MemoryManager *manager, size_t bytes)
+{
+    size_t page = (size_t)(sysconf(_SC_PAGESIZE));
+
+    if (bytes > ~(size_t)(0) - sizeof(Node) - page) return NULL;
+    size_t size = (bytes + sizeof(Node) + page - 1) & ~(page - 1);
+
+    Node *node = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (node == MAP_FAILED) return NULL;
+
+    node->free = false;
+    node->flags = NODE_MAPPED | NODE_ZEROED;
+    node->size = size - sizeof(Node);
+
+    pthread_mutex_lock(&manager->mapLock);
+    linkMapped(manager, node);
+    pthread_mutex_unlock(&manager->mapLock);
+
+    return (void *)((void *)(node) + sizeof(Node));
+}
+
+/**
+ * Finds if memory from a heap is a block in a mapping of its own. Small chunks have no node and must be ruled out
+ * first.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointer to be looked up
+ * @return - true if the block is mapped/false if it is in an arena
+ */
+static bool_type isMapped(MemoryManager *manager, void *memory)
+{
+    if (manager->mapThreshold == 0) return false; // Only node heaps map blocks, compact headers have no flags
+    return (((Node *)(memory - sizeof(Node)))->flags & NODE_MAPPED) ? true : false;
+}
+
+/**
+ * Unmaps a block that has a mapping of its own, giving its memory straight back to the operating system.
+ *
+ * @param manager - heap the block belongs to
+ * @param node - node at the start of the mapping
+ */
+static void unmapBlock(MemoryManager *manager, Node *node)
+{
+    pthread_mutex_lock(&manager->mapLock);
+    unlinkMapped(manager, node);
+    pthread_mutex_unlock(&manager->mapLock);
+
+    munmap(node, node->size + sizeof(Node));
+}
+
+/**
+ * Resizes a block that has a mapping of its own by remapping it, which moves the pages if it has to instead of copying
+ * the memory. The block stays mapped whatever its new size.
+ *
+ * @param manager - heap the block belongs to
+ * @param node - node at the start of the mapping
+ * @param bytes - new size of the block in bytes
+ * @return - void memory pointer, which may have moved/NULL if it can't be remapped, leaving the block as it was
+ */
+static void *remapBlock(MemoryManager *manager, Node *node, size_t bytes)
+{
+    size_t page = (size_t)(sysconf(_SC_PAGESIZE));
+
+    if (bytes > ~(size_t)(0) - sizeof(Node) - page) return NULL;
+    size_t size = (bytes + sizeof(Node) + page - 1) & ~(page - 1);
+
+    pthread_mutex_lock(&manager->mapLock); // The links of the neighbours point at the old address
+    unlinkMapped(manager, node);
+
+    Node *moved = mremap(node, node->size + sizeof(Node), size, MREMAP_MAYMOVE);
+    if (moved == MAP_FAILED) moved = NULL;
+    else moved->size = size - sizeof(Node);
+
+    linkMapped(manager, (moved == NULL) ? node : moved);
+    pthread_mutex_unlock(&manager->mapLock);
+
+    if (moved == NULL) return NULL;
+    return (void *)((void *)(moved) + sizeof(Node));
+}
+
+/**
+ * Deallocates a block of a heap with deferred coalescing by pushing it onto the pending stack of its arena with a
+ * compare and swap, without taking the lock. The block stays in use in the list until the stack is drained, so nothing
+ * else can touch it meanwhile. Blocks too small to hold the link are left to be released as normal.
+ *
+ * @param manager - heap the block belongs to
+ * @param node - node, or compact header, of the block
+ * @return - true if the block was left pending/false if it must be released instead
+ */
+static bool_type deferNode(MemoryManager *manager, Node *node)
+{
+    if (manager->headerSize == sizeof(Node) && node->size < sizeof(Node *)) return false; // Compact blocks all fit
+
+    Arena *arena = arenaOf(manager, node);
+
+    PENDING_LINK(manager, node) = __atomic_load_n(&arena->pending, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&arena->pending, &PENDING_LINK(manager, node), node, false, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+    return true;
+}
+
+/**
+ * Takes every pending block of an arena at once and releases them, coalescing each with its free neighbours. As the
+ * whole stack is swapped out in one go, blocks pushed meanwhile are simply left for the next drain. The caller must
+ * hold the lock.
+ *
+ * @param arena - arena to be drained
+ * @return - true if any blocks were released/false if there were none pending
+ */
+static bool_type drainPending(Arena *arena)
+{
+    MemoryManager *manager = arena->manager;
+
+    if (__atomic_load_n(&arena->pending, __ATOMIC_RELAXED) == NULL) return false; // Saves a write to a shared line
+    Node *node = __atomic_exchange_n(&arena->pending, NULL, __ATOMIC_ACQUIRE);
+
+    if (node == NULL) return false;
+
+    while (node != NULL)
+    {
+        Node *next = PENDING_LINK(manager, node);
+        manager->release(arena, node);
+        node = next;
+    }
+    return true;
+}
+
+/**
+ * Locks an arena for the calling thread to allocate from. The thread's own arena is tried first, and if another thread
+ * holds it the other arenas are tried in turn, with the thread moving to the first one that is free so that busy
+ * threads spread themselves out. If every arena is busy the thread waits on its own. Heaps with remote frees release
+ * the blocks other threads have handed back to the arena before it is allocated from, and only borrow the free arena
+ * for the one request, so that the arena a thread owns, and frees without queueing, never changes.
+ *
+ * @param manager - heap the arena is in
+ * @return - the locked arena
+ */
+static Arena *lockArena(MemoryManager *manager)
+{
+    Arena *arenas = manager->arenas;
+    Arena *arena = NULL;
+    size_t home = homeArena(manager);
+
+    if (lockTry(&arenas[home].lock) == true) arena = &arenas[home];
+
+    for (size_t i = 1; arena == NULL && i < manager->arenaCount; i++)
+    {
+        size_t index = (home + i) % manager->arenaCount;
+        if (lockTry(&arenas[index].lock) == true)
+        {
+            if (manager->remoteFrees == false) pthread_setspecific(manager->arenaKey, (void *)(index + 1));
+            arena = &arenas[index];
+        }
+    }
+
+    if (arena == NULL)
+    {
+        lockAcquire(&arenas[home].lock);
+        arena = &arenas[home];
+    }
+
+    if (manager->remoteFrees == true) drainPending(arena);
+    return arena;
+}
+
+/**
+ * Deallocates a block of a heap with remote frees that belongs to another thread's arena by leaving it pending for the
+ * arena, without taking the arena's lock, so that the thread that owns the arena releases it on its next allocation.
+ * Blocks in the calling thread's own arena, and blocks too small to hold the link, are left to be released as normal.
+ *
+ * @param manager - heap the block belongs to
+ * @param node - node, or compact header, of the block
+ * @return - true if the block was left pending/false if it must be released instead
+ */
+static bool_type remoteFree(MemoryManager *manager, Node *node)
+{
+    if (arenaOf(manager, node) == &manager->arenas[homeArena(manager)]) return false;
+    return deferNode(manager, node);
+}
+
+/**
+ * Background thread of a heap with deferred coalescing that drains the pending blocks of every arena each interval,
+ * so that they are coalesced before an allocation has to stop and do it. It runs until mm_destroy stops it.
+ *
+ * @param argument - heap to be swept
+ * @return - NULL
+ */
+static void *sweep(void *argument)
+{
+    MemoryManager *manager = argument;
+    struct timespec wake;
+
+    pthread_mutex_lock(&manager->sweepLock);
+    while (manager->sweeping == true)
+    {
+        clock_gettime(CLOCK_REALTIME, &wake);
+        wake.tv_sec += manager->sweepInterval / 1000;
+        wake.tv_nsec += (long)(manager->sweepInterval % 1000) * 1000000;
+        if (wake.tv_nsec >= 1000000000)
+        {
+            wake.tv_sec++;
+            wake.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&manager->sweepCond, &manager->sweepLock, &wake);
+
+        for (size_t i = 0; manager->sweeping == true && i < manager->arenaCount; i++)
+        {
+            Arena *arena = &manager->arenas[i];
+            if (__atomic_load_n(&arena->pending, __ATOMIC_RELAXED) == NULL) continue;
+
+            lockAcquire(&arena->lock);
+            drainPending(arena);
+            lockRelease(&arena->lock);
+        }
+    }
+    pthread_mutex_unlock(&manager->sweepLock);
+
+    return NULL;
+}
+
+/**
+ * Returns the calling thread's combining slot for a heap, taking over a slot left by a thread that has exited or
+ * pushing a new one onto the heap's slots on first use.
+ *
+ * @param manager - heap the slot is for
+ * @return - the thread's slot/NULL if one can't be created
+ */
+static CombineSlot *combineSlot(MemoryManager *manager)
+{
+    CombineSlot *slot = pthread_getspecific(manager->combineKey);
+    if (slot != NULL) return slot;
+
+    for (slot = __atomic_load_n(&manager->slots, __ATOMIC_ACQUIRE); slot != NULL; slot = slot->next)
+    {
+        bool_type inactive = false;
+        if (__atomic_compare_exchange_n(&slot->active, &inactive, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+    }
+
+    if (slot == NULL)
+    {
+        slot = calloc(1, sizeof(CombineSlot));
+        if (slot == NULL) return NULL;
+
+        slot->active = true;
+        slot->next = __atomic_load_n(&manager->slots, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&manager->slots, &slot->next, slot, false, __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED));
+    }
+
+    pthread_setspecific(manager->combineKey, slot);
+    return slot;
+}
+
+/**
+ * Destructor of the combining key, run when a thread exits. The slot is left in the heap's slots for the next thread
+ * that needs one, as a combiner may be looking at it.
+ *
+ * @param memory - the exiting thread's slot
+ */
+static void releaseSlot(void *memory)
+{
+    __atomic_store_n(&((CombineSlot *)(memory))->active, false, __ATOMIC_RELEASE);
+}
+
+/**
+ * Carries out the published requests of every thread while the calling thread holds an arena's lock, so the arena's
+ * list stays in one processor's cache rather than being handed from thread to thread with the lock. Each request is
+ * taken on with a compare and swap, as combiners of other arenas scan the same slots. Allocations are searched for in
+ * the held arena, while deallocations are handed straight back unless their node is in it. Passes repeat until one
+ * finds nothing.
+ *
+ * @param arena - arena whose lock is held
+ * @param own - the calling thread's slot, whose request isn't counted as carried out for another thread
+ */
+static void combinePass(Arena *arena, CombineSlot *own)
+{
+    MemoryManager *manager = arena->manager;
+
+    if (manager->remoteFrees == true) drainPending(arena); // The combiner allocates on the owner's behalf
+
+    for (int pass = 0; pass < COMBINE_PASSES; pass++)
+    {
+        bool_type served = false;
+
+        for (CombineSlot *slot = __atomic_load_n(&manager->slots, __ATOMIC_ACQUIRE); slot != NULL; slot = slot->next)
+        {
+            int state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+
+            if (state != COMBINE_ALLOCATE && state != COMBINE_RELEASE) continue;
+            if (!__atomic_compare_exchange_n(&slot->state, &state, COMBINE_BUSY, false, __ATOMIC_ACQUIRE,
+                                             __ATOMIC_RELAXED)) continue;
+            if (state == COMBINE_RELEASE && arenaOf(manager, slot->node) != arena)
+            {
+                __atomic_store_n(&slot->state, COMBINE_RELEASE, __ATOMIC_RELEASE); // Left for its own arena
+                continue;
+            }
+
+            if (state == COMBINE_ALLOCATE) slot->node = slot->search(arena, slot->bytes);
+            else manager->release(arena, slot->node);
+
+            if (slot != own) __atomic_store_n(&arena->combined, arena->combined + 1, __ATOMIC_RELAXED); // Read unlocked
+            __atomic_store_n(&slot->state, COMBINE_DONE, __ATOMIC_RELEASE);
+            served = true;
+        }
+
+        if (served == false) break;
+    }
+}
+
+/**
+ * Publishes a request in the calling thread's slot and waits for it to be carried out. While waiting the thread tries
+ * for the lock of the arena the request is for, and if it gets it becomes the combiner and carries out its own request
+ * along with those of every other waiting thread. Allocations are tried in the thread's own arena, and deallocations in
+ * the arena of their node.
+ *
+ * @param manager - heap the request is for
+ * @param search - unlocked search of the algorithm to allocate with/NULL to deallocate
+ * @param bytes - requested bytes to be allocated
+ * @param node - node to be deallocated
+ * @return - the allocated node/NULL if the arena had no room, the request couldn't be published or it was a deallocation
+ */
+static Node *combine(MemoryManager *manager, Node *(*search)(Arena *, size_t), size_t bytes, Node *node)
+{
+    CombineSlot *slot = combineSlot(manager);
+    Arena *arena = (search == NULL) ? arenaOf(manager, node) : &manager->arenas[homeArena(manager)];
+
+    if (slot == NULL)
+    {
+        if (search != NULL) return NULL; // The normal path allocates it instead
+        lockAcquire(&arena->lock);
+        manager->release(arena, node);
+        lockRelease(&arena->lock);
+        return NULL;
+    }
+
+    slot->search = search;
+    slot->bytes = bytes;
+    slot->node = node;
+    __atomic_store_n(&slot->state, (search == NULL) ? COMBINE_RELEASE : COMBINE_ALLOCATE, __ATOMIC_RELEASE);
+
+    for (unsigned int spins = 0; __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) != COMBINE_DONE; spins++)
+    {
+        if (__atomic_load_n(&slot->state, __ATOMIC_RELAXED) != COMBINE_BUSY && lockTry(&arena->lock) == true)
+        {
+            combinePass(arena, slot);
+            lockRelease(&arena->lock);
+        }
+        else if (spins % COMBINE_SPINS == COMBINE_SPINS - 1) sched_yield(); // Lets the combiner run on a busy machine
+        else spinPause();
+    }
+
+    Node *result = slot->node;
+    __atomic_store_n(&slot->state, COMBINE_IDLE, __ATOMIC_RELAXED);
+    return (search == NULL) ? NULL : result;
+}
+
+/**
+ * Pushes a chain of items onto a lock-free stack with a single compare and swap, bumping the tag so that the head
+ * can't be mistaken for one read before.
+ *
+ * @param head - tagged head of the stack
+ * @param first - first item of the chain
+ * @param last - last item of the chain, which is linked to the old head
+ * @param offset - offset into each item of its link
+ */
+static void stackPush(unsigned long long *head, void *first, void *last, size_t offset)
+{
+    unsigned long long oldHead = __atomic_load_n(head, __ATOMIC_RELAXED);
+    unsigned long long newHead;
+
+    do
+    {
+        __atomic_store_n(STACK_LINK(last, offset), STACK_POINTER(oldHead), __ATOMIC_RELAXED);
+        newHead = (unsigned long long)(size_t)(first) | ((STACK_TAG(oldHead) + 1) << STACK_TAG_SHIFT);
+    }while(!__atomic_compare_exchange_n(head, &oldHead, newHead, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/**
+ * Pops the first item of a lock-free stack. Items must stay readable while they may be on the stack, so that the link
+ * read from the head can be read even if another thread pops it first, in which case the tag makes the compare and
+ * swap fail.
+ *
+ * @param head - tagged head of the stack
+ * @param offset - offset into each item of its link
+ * @return - the item popped/NULL if the stack is empty
+ */
+static void *stackPop(unsigned long long *head, size_t offset)
+{
+    unsigned long long oldHead = __atomic_load_n(head, __ATOMIC_ACQUIRE);
+
+    while (STACK_POINTER(oldHead) != NULL)
+    {
+        void *item = STACK_POINTER(oldHead);
+        void *next = __atomic_load_n(STACK_LINK(item, offset), __ATOMIC_RELAXED);
+        unsigned long long newHead = (unsigned long long)(size_t)(next) | (STACK_TAG(oldHead) << STACK_TAG_SHIFT);
+
+        if (__atomic_compare_exchange_n(head, &oldHead, newHead, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+        {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Allocates a node from the lock-free stack of the request's size class without taking any lock. When the class is
+ * empty a batch of nodes is taken from the thread's arena under one lock using the given search, one is kept and the
+ * rest are pushed onto the stack at once. Nodes stay allocated in the shared list while on a stack, so nothing else
+ * can touch them and their memory is always readable.
+ *
+ * @param manager - heap to allocate from
+ * @param search - unlocked search of the algorithm used to refill the class
+ * @param bytes - requested bytes to be allocated
+ * @return - the node allocated/NULL if the request has no class or the arena is out of room
+ */
+static Node *classAllocate(MemoryManager *manager, Node *(*search)(Arena *, size_t), size_t bytes)
+{
+    size_t class = (bytes + CACHE_GRANULE - 1) / CACHE_GRANULE; // Smallest class whose nodes hold the request
+
+    if (class > CACHE_CLASSES) return NULL;
+
+    Node *node = stackPop(&manager->classStacks[class], sizeof(Node));
+    if (node != NULL) return node;
+
+    /* Refill the class in a batch, stopping early if the arena runs out of room */
+    Node *first = NULL;
+    Node *last = NULL;
+    Arena *arena = lockArena(manager);
+    for (size_t i = 0; i < CACHE_BATCH; i++)
+    {
+        Node *refill = search(arena, class * CACHE_GRANULE);
+        if (refill == NULL) break;
+
+        if (node == NULL) node = refill;
+        else
+        {
+            CACHE_LINK(refill) = first;
+            if (first == NULL) last = refill;
+            first = refill;
+        }
+    }
+    lockRelease(&arena->lock);
+
+    if (first != NULL) stackPush(&manager->classStacks[class], first, last, sizeof(Node));
+    return node;
+}
+
+/**
+ * Pushes a node being deallocated onto the lock-free stack of the largest size class it can hold, so that it always
+ * fits requests of that class, without taking any lock. Nodes that fit a class were handed out with their zeroed flag
+ * cleared by handOut, as it can't be written here.
+ *
+ * @param manager - heap the node is in
+ * @param node - the node to be unallocated
+ * @return - true if the node was pushed/false if it has no class and must be released instead
+ */
+static bool_type classFree(MemoryManager *manager, Node *node)
+{
+    size_t class = node->size / CACHE_GRANULE;
+
+    if (class < 1 || class > CACHE_CLASSES) return false;
+
+    stackPush(&manager->classStacks[class], node, node, sizeof(Node));
+    return true;
+}
+
+/**
+ * Empties every size class stack of a heap, releasing the nodes under the lock of their arena, which is only swapped
+ * when the next node belongs to a different arena. Each stack is taken whole by swapping in an empty head with a new
+ * tag.
+ *
+ * @param manager - heap whose classes are emptied
+ * @return - true if any nodes were released/false if every class was empty
+ */
+static bool_type drainClasses(MemoryManager *manager)
+{
+    Arena *locked = NULL;
+    bool_type drained = false;
+
+    for (size_t class = 1; class <= CACHE_CLASSES; class++)
+    {
+        unsigned long long head = __atomic_load_n(&manager->classStacks[class], __ATOMIC_ACQUIRE);
+        while (STACK_POINTER(head) != NULL &&
+               !__atomic_compare_exchange_n(&manager->classStacks[class], &head,
+                                            (STACK_TAG(head) + 1) << STACK_TAG_SHIFT, true, __ATOMIC_ACQUIRE,
+                                            __ATOMIC_ACQUIRE));
+
+        for (Node *node = STACK_POINTER(head); node != NULL;)
+        {
+            Node *next = CACHE_LINK(node);
+            Arena *arena = arenaOf(manager, node);
+
+            if (arena != locked)
+            {
+                if (locked != NULL) lockRelease(&locked->lock);
+                lockAcquire(&arena->lock);
+                locked = arena;
+            }
+            manager->release(arena, node);
+            drained = true;
+            node = next;
+        }
+    }
+    if (locked != NULL) lockRelease(&locked->lock);
+
+    return drained;
+}
+
+/**
+ * Finds which address range of an arena with region locking a node's header is in.
+ *
+ * @param arena - arena the node is in
+ * @param node - node to be looked up
+ * @return - index of the node's region lock
+ */
+static size_t regionOf(Arena *arena, Node *node)
+{
+    size_t region = (size_t)((void *)(node) - (void *)(arena->firstBlock)) / arena->regionSpan;
+    return (region < REGION_LOCKS) ? region : REGION_LOCKS - 1;
+}
+
+/**
+ * Takes a region lock for an operation unless it already holds it, noting it down so that it can be let go. Waiting
+ * is only allowed for a lock after every lock held, so that region locks are always waited on in address order.
+ *
+ * @param arena - arena the lock belongs to
+ * @param held - region locks held by the operation
+ * @param count - number of locks held, updated if the lock is taken
+ * @param region - index of the lock to be taken
+ */
+static void regionTake(Arena *arena, size_t *held, int *count, size_t region)
+{
+    for (int i = 0; i < *count; i++) if (held[i] == region) return;
+
+    lockAcquire(&arena->regionLocks[region]);
+    held[(*count)++] = region;
+}
+
+/**
+ * Lets go of every region lock an operation holds.
+ *
+ * @param arena - arena the locks belong to
+ * @param held - region locks held by the operation
+ * @param count - number of locks held, reset to zero
+ */
+static void regionDrop(Arena *arena, size_t *held, int *count)
+{
+    while (*count > 0) lockRelease(&arena->regionLocks[held[--(*count)]]);
+}
+
+/**
+ * Walks the list of an arena with region locking from a node with lock coupling, taking the lock of the next node's
+ * region before letting go of the current one, so that nothing can change the node being looked at. The walk stops at
+ * the end of the list or at the given node, whichever comes first.
+ *
+ * @param arena - arena to be searched
+ * @param node - node to start from, whose region lock must be the only one held
+ * @param stop - node to stop before/NULL to walk to the end of the list
+ * @param bytes - requested bytes to be allocated
+ * @param held - region locks held, left holding only the lock of the node found
+ * @return - first free node big enough/NULL if there is none
+ */
+static Node *regionScan(Arena *arena, Node *node, Node *stop, size_t bytes, size_t *held)
+{
+    while (node->free == false || node->size < bytes)
+    {
+        Node *next = node->next;
+        if (next == arena->firstBlock || (stop != NULL && (void *)(next) >= (void *)(stop))) return NULL;
+
+        size_t region = regionOf(arena, next);
+        if (region != held[0])
+        {
+            lockAcquire(&arena->regionLocks[region]);
+            lockRelease(&arena->regionLocks[held[0]]);
+            held[0] = region;
+        }
+        node = next;
+    }
+    return node;
+}
+
+/**
+ * Search of first fit and next fit for heaps with region locking, which only takes the shared side of the arena's lock
+ * and the locks of the regions it walks through, so threads searching and deallocating in different parts of a big
+ * arena don't wait on each other. Next fit starts from the last node used if that node still exists once its region
+ * is locked, walking to the end of the list and then from the start back up to it, while first fit walks the whole
+ * list. A node found is split with freeNode after locking the regions of the new node and of the node after it.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *regionFit(Arena *arena, size_t bytes)
+{
+    Node *first = arena->firstBlock;
+    Node *start = first;
+    size_t held[3];
+    int count = 0;
+
+    lockShared(&arena->lock);
+
+    if (arena->manager->regionFromLast == true)
+    {
+        Node *hint = __atomic_load_n(&arena->lastUsed, __ATOMIC_RELAXED);
+
+        /* A node is only merged away while its region is locked, which also moves lastUsed off of it */
+        regionTake(arena, held, &count, regionOf(arena, hint));
+        if (__atomic_load_n(&arena->lastUsed, __ATOMIC_RELAXED) == hint) start = hint;
+        else regionDrop(arena, held, &count);
+    }
+    if (count == 0) regionTake(arena, held, &count, regionOf(arena, first));
+
+    Node *node = regionScan(arena, start, NULL, bytes, held);
+    if (node == NULL && start != first)
+    {
+        regionDrop(arena, held, &count);
+        regionTake(arena, held, &count, regionOf(arena, first));
+        node = regionScan(arena, first, start, bytes, held);
+    }
+
+    if (node != NULL)
+    {
+        ArenaLock *lock = &arena->regionLocks[regionOf(arena, node)]; // Held since the scan found the node
+        __atomic_store_n(&lock->served, lock->served + 1, __ATOMIC_RELAXED); // Read unlocked
+
+        if (arena->manager->regionFromLast == true) __atomic_store_n(&arena->lastUsed, node, __ATOMIC_RELAXED);
+
+        if (node->size <= bytes + sizeof(Node)) node->free = false; // Too small to split
+        else
+        {
+            Node *next = node->next;
+
+            regionTake(arena, held, &count, regionOf(arena, (Node *)((void *)(node) + sizeof(Node) + bytes)));
+            regionTake(arena, held, &count, (next == first) ? REGION_TAIL : regionOf(arena, next));
+            freeNode(node, bytes);
+        }
+        handOut(arena, node);
+    }
+
+    regionDrop(arena, held, &count);
+    lockRelease(&arena->lock);
+    return node;
+}
+
+/**
+ * Checks whether the whole slice of an arena is one free node, so that a block spanning arenas can take it over.
+ *
+ * @param manager - heap the arena is in
+ * @param index - index of the arena
+ * @return - true if the arena is free/false otherwise
+ */
+static bool_type arenaFree(MemoryManager *manager, size_t index)
+{
+    Node *first = manager->arenas[index].firstBlock;
+
+    if ((void *)(first) != arenaStart(manager, index) || first->free == false) return false;
+    return ((void *)(first) + sizeof(Node) + first->size == arenaEnd(manager, index)) ? true : false;
+}
+
+/**
+ * Allocates a request that no arena can hold on its own as a block starting at the free last node of one arena and
+ * running on over the slices of the arenas after it, each of which must be entirely free. The first node of the last
+ * arena covered is moved up to the end of the block, unless too little would be left for a node, and the arenas the
+ * block covers whole are given their stand in node, so that every arena keeps a valid list. Every arena is locked in
+ * order while the arenas are looked over. The block is given back to the arenas by unspanNode as it is deallocated.
+ *
+ * @param manager - heap to allocate from
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if no run of arenas has room
+ */
+static Node *spanFit(MemoryManager *manager, size_t bytes)
+{
+    Arena *arenas = manager->arenas;
+    size_t count = manager->arenaCount;
+    size_t minimum = sizeof(Node) + ((manager->minimumSize + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1)); // A node
+    Node *node = NULL;
+    size_t first = 0, last = 0;
+    void *end = NULL;
+
+    if (bytes < manager->minimumSize) bytes = manager->minimumSize;
+    bytes = (bytes + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    if (bytes > (size_t)(manager->arenaEnd - arenaStart(manager, 0))) return NULL;
+
+    for (size_t i = 0; i < count; i++) lockAcquire(&arenas[i].lock);
+
+    for (size_t i = 0; node == NULL && i + 1 < count; i++)
+    {
+        if (arenas[i].firstBlock == &arenas[i].spanned) continue;
+
+        /* Nodes after the slice's last node are segments, which start with a node of their own */
+        Node *tail = arenas[i].firstBlock;
+        while (tail->next != arenas[i].firstBlock && (tail->next->flags & NODE_SEGMENT) == 0) tail = tail->next;
+        if (tail->free == false) continue;
+
+        end = (void *)(tail) + sizeof(Node) + bytes;
+        if (end <= arenaEnd(manager, i)) continue; // Left to the arena's own search, which rounds the request its way
+        for (last = i + 1; last < count && arenaFree(manager, last) == true; last++)
+        {
+            if (end <= arenaEnd(manager, last)) break;
+        }
+        if (last < count && arenaFree(manager, last) == true && end <= arenaEnd(manager, last))
+        {
+            node = tail;
+            first = i;
+        }
+    }
+
+    if (node != NULL)
+    {
+        /* Both the part of the last arena the block covers and the part left over must be able to hold a node */
+        if (end < arenaStart(manager, last) + minimum) end = arenaStart(manager, last) + minimum;
+        if (end + minimum > arenaEnd(manager, last)) end = arenaEnd(manager, last);
+
+        if (manager->indexRemove != NULL) manager->indexRemove(&arenas[first], node);
+        node->free = false;
+        node->flags &= ~NODE_ZEROED; // The first nodes of the arenas covered are part of the block
+        node->size = (size_t)(end - (void *)(node)) - sizeof(Node);
+
+        for (size_t i = first + 1; i <= last; i++)
+        {
+            Arena *arena = &arenas[i];
+            Node *old = arena->firstBlock;
+
+            if (manager->indexRemove != NULL) manager->indexRemove(arena, old);
+            if (end < arenaEnd(manager, i))
+            {
+                Node *rest = (Node *)(end);
+
+                rest->free = true;
+                rest->flags = NODE_SEGMENT | (old->flags & NODE_ZEROED);
+                rest->size = (size_t)(arenaEnd(manager, i) - end) - sizeof(Node);
+                replaceNode(old, rest);
+                arena->firstBlock = arena->lastUsed = rest;
+                if (manager->indexInsert != NULL) manager->indexInsert(arena, rest);
+            }
+            else
+            {
+                arena->spanned.free = false;
+                arena->spanned.flags = NODE_SEGMENT;
+                arena->spanned.size = 0;
+                replaceNode(old, &arena->spanned);
+                arena->firstBlock = arena->lastUsed = &arena->spanned;
+            }
+        }
+    }
+
+    for (size_t i = count; i > 0; i--) lockRelease(&arenas[i - 1].lock);
+    return node;
+}
+
+/**
+ * Shared body of the fit functions. Locks an arena, runs the unlocked search of an algorithm and unlocks it again
+ * before returning the memory address of the node found. If the arena can't hold the request the other arenas are
+ * searched in turn, each having its pending blocks released if it can't at first, and if none of them can the request
+ * is given a block running across free arenas, or failing that the heap is grown if it is growable. Heaps with
+ * lock-free size classes try the request's class first, heaps with flat combining publish the request for the lock
+ * holder and heaps with region locking search their own arena with only the regions it walks through locked. Should
+ * every arena be out of room, the size classes are emptied back into the lists and the arenas searched, and spanned,
+ * once more. Small requests are served by the small block tier first if the heap has one, while requests past the
+ * heap's map threshold are mapped on their own.
+ *
+ * @param manager - heap to allocate from
+ * @param search - unlocked search of the algorithm to be used
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+static void *lockedFit(MemoryManager *manager, Node *(*search)(Arena *, size_t), size_t bytes)
+{
+    if (bytes < 1 || manager == NULL) return NULL;
+
+    if (manager->smallBlocks == true && bytes <= SMALL_MAXIMUM)
+    {
+        void *chunk = smallAllocate(manager, bytes);
+        if (chunk != NULL) return chunk;
+    }
+    if (manager->mapThreshold != 0 && bytes >= manager->mapThreshold) return mapBlock(manager, bytes);
+
+    if (manager->lockFreeClasses == true)
+    {
+        Node *node = classAllocate(manager, search, bytes);
+        if (node != NULL) return (void *)((void *)(node) + manager->headerSize);
+    }
+    if (manager->combining == true)
+    {
+        Node *node = combine(manager, search, bytes, NULL);
+        if (node != NULL) return (void *)((void *)(node) + manager->headerSize);
+    }
+    if (manager->regionLocking == true && search == manager->fit)
+    {
+        Node *node = regionFit(&manager->arenas[homeArena(manager)], bytes);
+        if (node != NULL) return (void *)((void *)(node) + manager->headerSize);
+    }
+
+    bool_type spanning = (manager->spanning == true && search == manager->fit) ? true : false;
+
+    Arena *arena = lockArena(manager);
+    Node *node = search(arena, bytes);
+    if (node == NULL && drainPending(arena) == true) node = search(arena, bytes);
+    lockRelease(&arena->lock);
+
+    for (size_t i = 1; node == NULL && i < manager->arenaCount; i++)
+    {
+        Arena *other = &manager->arenas[(size_t)(arena - manager->arenas + i) % manager->arenaCount];
+
+        lockAcquire(&other->lock);
+        node = search(other, bytes);
+        if (node == NULL && drainPending(other) == true) node = search(other, bytes);
+        lockRelease(&other->lock);
+    }
+
+    if (node == NULL && spanning == true) node = spanFit(manager, bytes);
+
+    if (node == NULL && manager->growable == true)
+    {
+        arena = lockArena(manager);
+        node = search(arena, bytes); // Another thread may have grown the arena already
+        if (node == NULL && growArena(arena, bytes) == true) node = search(arena, bytes);
+        lockRelease(&arena->lock);
+    }
+
+    if (node == NULL && manager->lockFreeClasses == true && drainClasses(manager) == true)
+    {
+        for (size_t i = 0; node == NULL && i < manager->arenaCount; i++)
+        {
+            lockAcquire(&manager->arenas[i].lock);
+            node = search(&manager->arenas[i], bytes);
+            lockRelease(&manager->arenas[i].lock);
+        }
+        if (node == NULL && spanning == true) node = spanFit(manager, bytes);
+    }
+
+    if (node == NULL) return NULL;
+    return (void *)((void *)(node) + manager->headerSize);
+}
+
+/**
+ * The algorithm allocates memory by looking for the first free node with enough space to hold a new node and a struct,
+ * even if the node is too big. Once a node has been found, its details are changed and a new free node is created if a
+ * hole is created. The caller must hold the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *firstFitNode(Arena *arena, size_t bytes)
+{
+    size_t totalBytes = bytes + sizeof(Node); // total size of a new node + memory block
+    Node *node = arena->firstBlock->prev;
+
+    do
+    {
+        node = node->next; // Increment through the list
+        if (node->free == false || node->size < bytes) continue;  // Don't use non free nodes or too small nodes
+
+        /* If block found has exact size or is exact size of memory + size of node allocate */
+        if (node->size <= totalBytes)
+        {
+            node->free = false;
+            return handOut(arena, node);
+        }
+        return handOut(arena, freeNode(node, bytes));
+
+    }while(node->next != arena->firstBlock); // End of loop met
+
+    return NULL;
+}
+
+/**
+ * This algorithm is similar to first fit but rather than starting from the first block every time when looping, it
+ * starts from the last node accessed. This means that after accessing/creating a new node, a variable - lastUsed - is
+ * updated to update the starting point. This variable is set to the start block at the start of the program. Once a
+ * node has been found, its details are changed and a new free node is created if a hole is created. The caller must
+ * hold the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *nextFitNode(Arena *arena, size_t bytes)
+{
+    size_t totalBytes = bytes + sizeof(Node); // total size of a new node + memory block
+
+    /* lastUsed is used for readability but isn't necessary as firstBlock could just be continually updated for it to
+     * also work as intended. */
+    Node *node = arena->lastUsed->prev;
+
+    do
+    {
+        node = node->next; // Increment through the list
+        if (node->free == false || node->size < bytes) continue;  // Don't use non free nodes or too small nodes
+
+        arena->lastUsed = node; // Update last accessed node
+
+        /* If block found has exact size or is exact size of memory + size of node allocate */
+        if (node->size <= totalBytes)
+        {
+            node->free = false;
+            return handOut(arena, node);
+        }
+        return handOut(arena, freeNode(node, bytes));
+
+    }while(node->next != arena->lastUsed); // End of loop met
+
+    return NULL;
+}
+
+/**
+ * This algorithm allocates memory by finding the smallest sized node possible that will fit the requested amount of
+ * bytes. Free nodes are kept in a red-black tree ordered by size, so rather than looping over the entire list the tree
+ * is walked down from the root, remembering the last node that was big enough and moving to smaller nodes until there
+ * are none. The node is then either used whole if a new node can't be created or a new node is created using the
+ * freeNode function. The caller must hold the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *bestFitNode(Arena *arena, size_t bytes)
+{
+    Node *bestNode = NULL;
+    Node *node = arena->treeRoot;
+
+    bytes = indexedSize(arena, bytes);
+
+    while (node != NULL)
+    {
+        if (node->size < bytes) node = TREE_LINKS(node)->child[1]; // Too small, look at bigger nodes
+        else
+        {
+            bestNode = node;
+            node = TREE_LINKS(node)->child[0];
+        }
+    }
+
+    if (bestNode != NULL) bestNode = useNode(arena, bestNode, bytes);
+    return bestNode;
+}
+
+/**
+ * This algorithm allocates memory by using the biggest sized node possible that will fit the requested amount of bytes.
+ * Free nodes are kept in a pairing heap with the biggest node at its root, so rather than looping over the entire list
+ * the root is checked. The node is then either used whole if a new node can't be created or a new node is created using
+ * the freeNode function, with the heap updated as the root is taken out and the new node added. The caller must hold
+ * the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *worstFitNode(Arena *arena, size_t bytes)
+{
+    bytes = indexedSize(arena, bytes);
+
+    if (arena->heapRoot == NULL || arena->heapRoot->size < bytes) return NULL; // Not even the biggest node is big enough
+    return useNode(arena, arena->heapRoot, bytes);
+}
+
+/**
+ * This algorithm keeps a separate list of free nodes for every power of two size class, so that only free nodes that
+ * could hold the request are looked at. The class of the request is searched first fit, after which any node in a
+ * bigger class is guaranteed to fit so the first one found is used. The node is then split using the freeNode function
+ * if a new node can be created. The caller must hold the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *segregatedFitNode(Arena *arena, size_t bytes)
+{
+    bytes = indexedSize(arena, bytes);
+
+    for (size_t class = sizeClass(bytes); class < SIZE_CLASSES; class++)
+    {
+        for (Node *node = arena->freeLists[class]; node != NULL; node = FREE_LINKS(node)->nextFree)
+        {
+            if (node->size >= bytes) return useNode(arena, node, bytes);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * This algorithm is two-level segregated fit (TLSF), which allocates in bounded time without looping over any list.
+ * The request is rounded up to the start of the next second level list, so that every node in that list or any list
+ * after it will fit. The first non empty list is then found with find first set instructions on the second level bitmap
+ * of the request's first level, or failing that on the first level bitmap. The first node in that list is used and a
+ * new node is created using the freeNode function if a hole is created. When only the request's own list could hold it,
+ * the first node there is tried as well. The caller must hold the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *tlsfFitNode(Arena *arena, size_t bytes)
+{
+    size_t first, second;
+    size_t search = indexedSize(arena, bytes);
+
+    bytes = search;
+    if (search >= TLSF_SL_COUNT)
+    {
+        size_t round = ((size_t)(1) << (SIZE_CLASSES - 1 - __builtin_clzl(search) - TLSF_SL_LOG2)) - 1;
+        if (search + round > search) search += round; // Stays in the last list rather than overflowing
+    }
+    tlsfMapping(search, &first, &second);
+
+    unsigned int secondMap = arena->tlsfSecondMap[first] & (~0U << second);
+    if (secondMap == 0)
+    {
+        size_t firstMap = (first + 1 < TLSF_FL_COUNT) ? arena->tlsfFirstMap & (~(size_t)(0) << (first + 1)) : 0;
+        if (firstMap != 0)
+        {
+            first = __builtin_ctzl(firstMap);
+            secondMap = arena->tlsfSecondMap[first];
+        }
+    }
+
+    if (secondMap != 0) return useNode(arena, arena->tlsfLists[first][__builtin_ctz(secondMap)], bytes);
+
+    /* Nothing after the request's own list, but its first node may still be big enough */
+    tlsfMapping(bytes, &first, &second);
+    Node *node = arena->tlsfLists[first][second];
+    if (node != NULL && node->size >= bytes) return useNode(arena, node, bytes);
+
+    return NULL;
+}
+
+/**
+ * Finds the order of a buddy block, which is the power of two of its size including its node.
+ *
+ * @param node - the buddy block
+ * @return - order of the block
+ */
+static size_t buddyOrder(Node *node)
+{
+    return SIZE_CLASSES - 1 - __builtin_clzl(node->size + sizeof(Node));
+}
+
+/**
+ * Finds the order of the smallest buddy block that can hold a request along with its node and, once freed, its links.
+ *
+ * @param bytes - requested bytes
+ * @return - order of the block
+ */
+static size_t buddyRequestOrder(size_t bytes)
+{
+    size_t total = sizeof(Node) + ((bytes < sizeof(FreeLinks)) ? sizeof(FreeLinks) : bytes);
+
+    if (total < bytes || total > ((size_t)(1) << (SIZE_CLASSES - 1))) return SIZE_CLASSES; // Can never fit
+    return SIZE_CLASSES - __builtin_clzl(total - 1);
+}
+
+/**
+ * This algorithm is a binary buddy allocator, where every block is a power of two in size and is aligned to its size
+ * from the start of the heap. Free blocks are kept in one free list per order using the segregated fit lists. The
+ * smallest order that can hold the request is found and the first block of that order or above is taken, which is then
+ * halved until it is the right size, with the upper half of each split left free as the buddy of the lower half. The
+ * blocks stay in address order in the list so the heap can still be printed and checked. The caller must hold the
+ * lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *buddyFitNode(Arena *arena, size_t bytes)
+{
+    size_t order = buddyRequestOrder(bytes);
+    size_t class = order - 1; // Blocks of an order have sizes in the class below it, as the node is not counted
+    Node *node = NULL;
+
+    if (order >= SIZE_CLASSES) return NULL;
+    while (class < SIZE_CLASSES && arena->freeLists[class] == NULL) class++;
+    if (class >= SIZE_CLASSES) return NULL;
+
+    node = arena->freeLists[class];
+    segregatedRemove(arena, node);
+
+    /* Halve the block until it is the requested order, freeing the upper half each time */
+    for (size_t current = class + 1; current > order; current--)
+    {
+        size_t half = (size_t)(1) << (current - 1);
+        Node *buddy = (Node *)((void *)(node) + half);
+
+        buddy->free = true;
+        buddy->flags = node->flags & NODE_ZEROED;
+        buddy->size = half - sizeof(Node);
+        buddy->prev = node;
+        buddy->next = node->next;
+        node->next->prev = buddy;
+        node->next = buddy;
+        node->size = half - sizeof(Node);
+
+        segregatedInsert(arena, buddy);
+    }
+
+    node->free = false;
+    return handOut(arena, node);
+}
+
+/**
+ * Links a free compact block into the free list of its size class, writing its footer so that the block after it can
+ * find its start.
+ *
+ * @param arena - arena the block is in
+ * @param block - free compact block to be added
+ */
+static void compactInsert(Arena *arena, Node *block)
+{
+    size_t size = COMPACT_SIZE(block);
+    size_t class = sizeClass(size);
+
+    *(size_t *)((void *)(block) + size - sizeof(size_t)) = size; // Footer
+    COMPACT_HEADER((void *)(block) + size) |= COMPACT_PREV_FREE;
+
+    COMPACT_LINKS(block)->prevFree = NULL;
+    COMPACT_LINKS(block)->nextFree = arena->freeLists[class];
+
+    if (arena->freeLists[class] != NULL) COMPACT_LINKS(arena->freeLists[class])->prevFree = block;
+    arena->freeLists[class] = block;
+}
+
+/**
+ * Unlinks a compact block from the free list of its size class.
+ *
+ * @param arena - arena the block is in
+ * @param block - free compact block to be removed
+ */
+static void compactRemove(Arena *arena, Node *block)
+{
+    FreeLinks *links = COMPACT_LINKS(block);
+
+    if (links->prevFree != NULL) COMPACT_LINKS(links->prevFree)->nextFree = links->nextFree;
+    else arena->freeLists[sizeClass(COMPACT_SIZE(block))] = links->nextFree;
+
+    if (links->nextFree != NULL) COMPACT_LINKS(links->nextFree)->prevFree = links->prevFree;
+}
+
+/**
+ * This algorithm keeps a single size_t in front of every block rather than a node. The size of the block is stored
+ * with its low bits used to mark whether it and the block before it are free, neighbours are found from the size, and
+ * free blocks end with a copy of their size (a boundary tag) so that the block after can find their start. Free blocks
+ * are kept in the segregated free lists and searched the same way as segregated fit, with the rest of a block split off
+ * if it is big enough to be a block of its own. The caller must hold the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @return - allocated block/NULL if can't be allocated
+ */
+static Node *compactFitNode(Arena *arena, size_t bytes)
+{
+    if (bytes > ~(size_t)(0) - COMPACT_MINIMUM) return NULL; // Would overflow once rounded
+
+    size_t need = (bytes + 2 * sizeof(size_t) - 1) & ~(sizeof(size_t) - 1); // Header plus the aligned request
+    if (need < COMPACT_MINIMUM) need = COMPACT_MINIMUM;
+
+    for (size_t class = sizeClass(need); class < SIZE_CLASSES; class++)
+    {
+        for (Node *block = arena->freeLists[class]; block != NULL; block = COMPACT_LINKS(block)->nextFree)
+        {
+            size_t size = COMPACT_SIZE(block);
+            if (size < need) continue;
+
+            compactRemove(arena, block);
+            if (size - need >= COMPACT_MINIMUM)
+            {
+                void *rest = (void *)(block) + need;
+                COMPACT_HEADER(rest) = (size - need) | COMPACT_FREE;
+                compactInsert(arena, rest);
+                COMPACT_HEADER(block) = need | (COMPACT_HEADER(block) & COMPACT_PREV_FREE);
+            }
+            else
+            {
+                COMPACT_HEADER(block) &= ~(size_t)(COMPACT_FREE);
+                COMPACT_HEADER((void *)(block) + size) &= ~(size_t)(COMPACT_PREV_FREE);
+            }
+            return block;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Allocates memory using the first fit algorithm. This function also locks the current thread when accessing the main
+ * pool of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *firstFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &firstFitNode, bytes);
+}
+
+/**
+ * Allocates memory using the next fit algorithm. This function also locks the current thread when accessing the main
+ * pool of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *nextFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &nextFitNode, bytes);
+}
+
+/**
+ * Allocates memory using the best fit algorithm. This function also locks the current thread when accessing the main
+ * pool of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *bestFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &bestFitNode, bytes);
+}
+
+/**
+ * Allocates memory using the worst fit algorithm. This function also locks the current thread when accessing the main
+ * pool of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *worstFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &worstFitNode, bytes);
+}
+
+/**
+ * Allocates memory using the segregated fit algorithm. This function also locks the current thread when accessing the
+ * main pool of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *segregatedFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &segregatedFitNode, bytes);
+}
+
+/**
+ * Allocates memory using the TLSF algorithm. This function also locks the current thread when accessing the main pool
+ * of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *tlsfFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &tlsfFitNode, bytes);
+}
+
+/**
+ * Allocates memory using the buddy algorithm. This function also locks the current thread when accessing the main pool
+ * of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *buddyFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &buddyFitNode, bytes);
+}
+
+/**
+ * Allocates memory using the compact algorithm. This function also locks the current thread when accessing the main
+ * pool of memory and unlocks it when returning the memory address.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *compactFit(size_t bytes)
+{
+    return lockedFit(defaultManager, &compactFitNode, bytes);
+}
+
+/**
+ * Finds how many bytes at the start of the memory of a free node the heap's index writes its links to.
+ *
+ * @param manager - heap to be looked up
+ * @return - bytes of links in each free node
+ */
+static size_t linkSize(MemoryManager *manager)
+{
+    if (manager->fit == &buddyFitNode) return sizeof(FreeLinks);
+    return (manager->indexInsert != NULL) ? manager->minimumSize : 0;
+}
+
+/**
+ * Finds if memory lies in a mapping the heap made for itself, either the whole heap of mm_create_mapped or a segment
+ * it grew into. Only such memory is known to be private and anonymous, and so to read as zero once it is advised.
+ *
+ * @param manager - heap to be looked up
+ * @param memory - memory to be found
+ * @return - true if the heap mapped the memory itself
+ */
+static bool_type ownsMapping(MemoryManager *manager, void *memory)
+{
+    if (manager->mapping != NULL && memory >= manager->mapping && memory < manager->mapping + manager->mappingSize)
+    {
+        return true;
+    }
+
+    for (Segment *segment = __atomic_load_n(&manager->segments, __ATOMIC_ACQUIRE); segment != NULL;
+         segment = segment->next)
+    {
+        if (memory > (void *)(segment) && memory < (void *)(segment) + segment->size) return true;
+    }
+    return false;
+}
+
+/**
+ * Gives the whole pages of a free node between two addresses back to the operating system, which maps them back in as
+ * zero when they are next touched. The less than a page left at either end is cleared by hand so that the node can be
+ * marked as zeroed, which relies on everything in the node outside of the range already being zero. Memory given to
+ * mm_create, which may be shared or file backed, and ranges without a whole page are left alone and keep their flag.
+ * Any links of the index are left alone. The caller must hold the lock.
+ *
+ * @param manager - heap the node is in
+ * @param node - free node to be trimmed
+ * @param from - start of the range that may not be zero, which may be the node itself
+ * @param to - end of the range that may not be zero, at most the end of the node
+ * @return - bytes given back
+ */
+static size_t trimNode(MemoryManager *manager, Node *node, void *from, void *to)
+{
+    size_t page = (size_t)(sysconf(_SC_PAGESIZE));
+    void *memory = (void *)(node) + sizeof(Node) + linkSize(manager);
+
+    if (from < memory) from = memory;
+    if (to <= from || ownsMapping(manager, node) == false) return 0;
+
+    void *start = (void *)(((size_t)(from) + page - 1) & ~(page - 1));
+    void *stop = (void *)((size_t)(to) & ~(page - 1));
+
+    if (stop <= start) return 0; // No whole pages, and clearing it all by hand would cost as much as using it
+    if (madvise(start, (size_t)(stop - start), MADV_DONTNEED) != 0) return 0;
+
+    memset(from, 0, (size_t)(start - from));
+    memset(stop, 0, (size_t)(to - stop));
+    node->flags |= NODE_ZEROED;
+    return (size_t)(stop - start);
+}
+
+/**
+ * Gives the arenas after a node's own arena back the parts of their slices a block handed out by spanFit covers, each
+ * becoming the first node of its arena again and being released there, and cuts the node back to the end of its own
+ * arena's slice. The arenas are locked one at a time in order, after the node's own. The caller must hold the lock of
+ * the node's arena.
+ *
+ * @param arena - arena the node is in
+ * @param node - spanning node being deallocated
+ */
+static void unspanNode(Arena *arena, Node *node)
+{
+    MemoryManager *manager = arena->manager;
+    size_t index = (size_t)(arena - manager->arenas);
+    void *end = (void *)(node) + sizeof(Node) + node->size;
+
+    for (size_t i = index + 1; i < manager->arenaCount && arenaStart(manager, i) < end; i++)
+    {
+        Arena *other = &manager->arenas[i];
+        Node *first = arenaStart(manager, i);
+        void *stop = (end < arenaEnd(manager, i)) ? end : arenaEnd(manager, i);
+
+        lockAcquire(&other->lock);
+        first->free = false;
+        first->flags = NODE_SEGMENT;
+        first->size = (size_t)(stop - (void *)(first)) - sizeof(Node);
+
+        if (other->firstBlock == &other->spanned) replaceNode(&other->spanned, first);
+        else
+        {
+            /* Goes in front of the node the block left at the start of the arena, which can now join it */
+            first->next = other->firstBlock;
+            first->prev = other->firstBlock->prev;
+            first->prev->next = first;
+            first->next->prev = first;
+            other->firstBlock->flags &= ~NODE_SEGMENT;
+        }
+        if (other->lastUsed == &other->spanned) other->lastUsed = first;
+        other->firstBlock = first;
+
+        manager->release(other, first);
+        lockRelease(&other->lock);
+    }
+
+    node->size = (size_t)(arenaEnd(manager, index) - (void *)(node)) - sizeof(Node);
+}
+
+/**
+ * Coalesces a node that is being deallocated by setting node->free to true so that it can be used in allocating. If
+ * there is a free node before or after it, said node, is disconnected and the current node is then grown into it
+ * creating one big node. Also, if nodes are being coalesced the lastUsed node is preserved if its node is unlinked.
+ * Indexed algorithms have the neighbours taken out of their index before being joined and the resulting node added
+ * back. Only the node and any neighbour that isn't zeroed may hold data, so once past the trim threshold only they are
+ * trimmed and the rest of the joined node stays zeroed. A block spanning arenas first gives the others their parts back.
+ * The caller must hold the lock.
+ *
+ * @param arena - arena the node is in
+ * @param node - the node to be unallocated
+ */
+static void releaseNode(Arena *arena, Node *node)
+{
+    if (spansArenas(arena, node) == true) unspanNode(arena, node);
+
+    Node *nextNode = node->next;
+    void *dirty = node; // Everything of the joined node outside of dirty up to dirtyEnd is zero
+    void *dirtyEnd = (void *)(node) + sizeof(Node) + node->size;
+
+    node->free = true;
+    node->flags &= ~NODE_ZEROED; // It may have been written to, and so will anything it is coalesced into
+
+    /* If next node can be coalesced and prevent coalescing across the start of a segment (front & end joining). The
+     * first node is ruled out before it is looked at, as with region locking only the tail lock is held for it */
+    if(nextNode != arena->firstBlock && (nextNode->flags & NODE_SEGMENT) == 0 && nextNode->free == true)
+    {
+        /* If in next fit and coalesced node is last used, update last used to preserve */
+        Node *expected = nextNode;
+        __atomic_compare_exchange_n(&arena->lastUsed, &expected, node, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        if (arena->manager->indexRemove != NULL) arena->manager->indexRemove(arena, nextNode);
+
+        /* A zeroed node after only adds its node and links, which become part of the memory */
+        dirtyEnd = (void *)(nextNode) + sizeof(Node);
+        dirtyEnd += (nextNode->flags & NODE_ZEROED) ? linkSize(arena->manager) : nextNode->size;
+
+        node->next = nextNode->next;
+        node->size += nextNode->size + sizeof(Node); // Increase main node size
+
+        nextNode->next->prev = node; // If they were the only two nodes this points node back at itself
+    }
+
+    /* If previous node can be coalesced and prevent coalescing across the start of a segment (front & end joining) */
+    Node *prevNode = ((node->flags & NODE_SEGMENT) == 0) ? node->prev : node;
+    if(prevNode != node && prevNode->free == true)
+    {
+        /* If in next fit and coalesced node is last used, update last used to preserve */
+        Node *expected = node;
+        __atomic_compare_exchange_n(&arena->lastUsed, &expected, prevNode, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        if (arena->manager->indexRemove != NULL) arena->manager->indexRemove(arena, prevNode);
+
+        if ((prevNode->flags & NODE_ZEROED) == 0) dirty = prevNode;
+
+        prevNode->next = node->next; // Un-link old node
+        prevNode->size += node->size + sizeof(Node); // Increase main node size
+        prevNode->flags &= ~NODE_ZEROED;
+
+        if (node->next != node) node->next->prev = prevNode;
+        node = prevNode;
+    }
+
+    size_t threshold = arena->manager->trimThreshold;
+    if (threshold != 0 && node->size >= threshold) trimNode(arena->manager, node, dirty, dirtyEnd);
+    if (arena->manager->indexInsert != NULL) arena->manager->indexInsert(arena, node);
+}
+
+/**
+ * Deallocates a node of a heap with region locking, taking only the shared side of the arena's lock and the locks of
+ * the regions of the node, the node before it and the node after it, along with the node after that if the one after
+ * is free and will be coalesced. The node before can only be waited on after letting go of the node's own lock, so it
+ * is tried first, and if it has to be waited on the node's lock is taken again and the node before checked to still be
+ * the same. The tail lock stands in for the first node whenever the link back to the last node could change.
+ *
+ * @param arena - arena the node is in
+ * @param node - the node to be unallocated
+ */
+static void regionRelease(Arena *arena, Node *node)
+{
+    Node *first = arena->firstBlock;
+    size_t held[4];
+    int count = 0;
+
+    lockShared(&arena->lock);
+
+    while (true)
+    {
+        size_t own = regionOf(arena, node);
+        regionTake(arena, held, &count, own);
+
+        if ((node->flags & NODE_SEGMENT) == 0)
+        {
+            Node *prevNode = node->prev;
+            size_t region = regionOf(arena, prevNode);
+
+            if (region != own && lockTry(&arena->regionLocks[region]) == true) held[count++] = region;
+            else if (region != own)
+            {
+                regionDrop(arena, held, &count);
+                regionTake(arena, held, &count, region);
+                regionTake(arena, held, &count, own);
+                if (node->prev != prevNode) // The node before was split or coalesced meanwhile
+                {
+                    regionDrop(arena, held, &count);
+                    continue;
+                }
+            }
+        }
+        break;
+    }
+
+    /* The node is in use, so the node after it can't change, and neither can the node after that once it is locked */
+    Node *nextNode = node->next;
+    if (nextNode == first) regionTake(arena, held, &count, REGION_TAIL);
+    else
+    {
+        regionTake(arena, held, &count, regionOf(arena, nextNode));
+        if (nextNode->free == true)
+        {
+            regionTake(arena, held, &count, (nextNode->next == first) ? REGION_TAIL : regionOf(arena, nextNode->next));
+        }
+    }
+
+    ArenaLock *lock = &arena->regionLocks[regionOf(arena, node)];
+    __atomic_store_n(&lock->served, lock->served + 1, __ATOMIC_RELAXED); // Read unlocked
+    releaseNode(arena, node);
+
+    regionDrop(arena, held, &count);
+    lockRelease(&arena->lock);
+}
+
+/**
+ * Frees a buddy block, merging it with its buddy for as long as the buddy is also free and whole. The buddy of a block
+ * is found by flipping the bit of its order in its offset from the start of the heap, so no list needs to be walked.
+ * As with releaseNode, only the block and any buddy that isn't zeroed are trimmed once past the trim threshold. The
+ * caller must hold the lock.
+ *
+ * @param arena - arena the node is in
+ * @param node - the node to be unallocated
+ */
+static void buddyRelease(Arena *arena, Node *node)
+{
+    size_t order = buddyOrder(node);
+    size_t threshold = arena->manager->trimThreshold;
+    void *dirty = node; // Everything of the merged block outside of dirty up to dirtyEnd is zero
+    void *dirtyEnd = (void *)(node) + sizeof(Node) + node->size;
+
+    while (order < SIZE_CLASSES - 1)
+    {
+        size_t offset = (size_t)((void *)(node) - (void *)(arena->firstBlock));
+        Node *buddy = (Node *)((void *)(arena->firstBlock) + (offset ^ ((size_t)(1) << order)));
+
+        /* The buddy must exist and be free, and not have been split into smaller blocks */
+        if ((void *)(buddy) + ((size_t)(1) << order) > arena->buddyEnd) break;
+        if (buddy->free == false || buddy->size != node->size) break;
+
+        segregatedRemove(arena, buddy);
+        Node *absorbed = NULL; // Zeroed upper half, which only adds its node and links to the merged block
+        if (buddy < node)
+        {
+            if ((buddy->flags & NODE_ZEROED) == 0) dirty = buddy;
+
+            Node *swap = node;
+            node = buddy;
+            buddy = swap;
+        }
+        else if ((buddy->flags & NODE_ZEROED) == 0) dirtyEnd = (void *)(buddy) + sizeof(Node) + buddy->size;
+        else absorbed = buddy;
+
+        node->next = buddy->next; // Un-link the upper half
+        buddy->next->prev = node;
+        node->size += buddy->size + sizeof(Node);
+        order++;
+
+        /* Cleared here rather than widening the range, which would take in any zeroed halves before it as well */
+        if (absorbed != NULL && threshold != 0) memset(absorbed, 0, sizeof(Node) + linkSize(arena->manager));
+    }
+
+    node->free = true;
+    node->flags &= ~NODE_ZEROED; // It may have been written to, and so will anything it is merged into
+
+    if (threshold != 0 && node->size >= threshold) trimNode(arena->manager, node, dirty, dirtyEnd);
+    segregatedInsert(arena, node);
+}
+
+/**
+ * Splits the heap into the biggest buddy blocks that fit, each aligned to its size from the start of the heap. Any
+ * space at the end too small for a block is left out.
+ *
+ * @param arena - arena to be split
+ * @param size - size of heap in bytes
+ */
+static void buddySplitHeap(Arena *arena, size_t size)
+{
+    size_t offset = 0;
+    size_t minimum = (size_t)(1) << buddyRequestOrder(1);
+    unsigned int flags = arena->firstBlock->flags & NODE_ZEROED;
+    Node *last = NULL;
+
+    while (size - offset >= minimum)
+    {
+        size_t order = SIZE_CLASSES - 1 - __builtin_clzl(size - offset);
+        if (offset != 0 && (size_t)__builtin_ctzl(offset) < order) order = __builtin_ctzl(offset); // Keep it aligned
+
+        Node *node = (Node *)((void *)(arena->firstBlock) + offset);
+        node->free = true;
+        node->flags = flags;
+        node->size = ((size_t)(1) << order) - sizeof(Node);
+        node->prev = (last == NULL) ? node : last;
+        node->next = arena->firstBlock;
+
+        if (last != NULL) last->next = node;
+        arena->firstBlock->prev = node;
+        segregatedInsert(arena, node);
+
+        last = node;
+        offset += (size_t)(1) << order;
+    }
+    arena->buddyEnd = (void *)(arena->firstBlock) + offset;
+}
+
+/**
+ * Frees a compact block, joining it with the blocks either side if they are free. The block after is found from the
+ * size in the header and the block before from its footer, which is only read when the header says it is free. The
+ * caller must hold the lock.
+ *
+ * @param arena - arena the block is in
+ * @param block - the block to be unallocated
+ */
+static void compactRelease(Arena *arena, Node *block)
+{
+    size_t size = COMPACT_SIZE(block);
+    size_t flags = COMPACT_HEADER(block) & COMPACT_PREV_FREE;
+    void *next = (void *)(block) + size;
+
+    if (COMPACT_HEADER(next) & COMPACT_FREE)
+    {
+        compactRemove(arena, next);
+        size += COMPACT_SIZE(next);
+    }
+
+    if (flags & COMPACT_PREV_FREE)
+    {
+        size_t prevSize = *(size_t *)((void *)(block) - sizeof(size_t));
+
+        block = (Node *)((void *)(block) - prevSize);
+        compactRemove(arena, block);
+        size += prevSize;
+        flags = COMPACT_HEADER(block) & COMPACT_PREV_FREE; // Never set, as the block before it wasn't free either
+    }
+
+    COMPACT_HEADER(block) = size | flags | COMPACT_FREE;
+    compactInsert(arena, block);
+}
+
+/**
+ * Turns an arena into a single free compact block, ended by a header of size 0 that is never free so that the last
+ * block has a neighbour to check.
+ *
+ * @param arena - arena to be set up
+ * @param size - size of the arena in bytes
+ */
+static void compactSplitHeap(Arena *arena, size_t size)
+{
+    void *block = arena->firstBlock;
+    size_t blockSize = (size & ~(sizeof(size_t) - 1)) - sizeof(size_t); // Leaves room for the end header
+
+    COMPACT_HEADER(block + blockSize) = 0;
+    COMPACT_HEADER(block) = blockSize | COMPACT_FREE;
+    compactInsert(arena, block);
+}
+
+/**
+ * Support function for aligned allocation that frees the first gap bytes of a node found by the algorithm, so that the
+ * rest starts on the alignment. The gap becomes a node or compact block of its own and is released, joining it to any
+ * free neighbour before it.
+ *
+ * @param arena - arena the node is in
+ * @param node - allocated node or compact block to be split
+ * @param gap - bytes from the start of the node to the start of the aligned node
+ * @return - the aligned node
+ */
+static Node *alignFront(Arena *arena, Node *node, size_t gap)
+{
+    Node *alignedNode = (Node *)((void *)(node) + gap);
+
+    if (arena->manager->fit == &compactFitNode)
+    {
+        COMPACT_HEADER(alignedNode) = COMPACT_SIZE(node) - gap;
+        COMPACT_HEADER(node) = gap | (COMPACT_HEADER(node) & COMPACT_PREV_FREE);
+    }
+    else
+    {
+        alignedNode->free = false;
+        alignedNode->flags = node->flags & NODE_ZEROED;
+        alignedNode->size = node->size - gap;
+        alignedNode->prev = node;
+        alignedNode->next = node->next;
+        node->next->prev = alignedNode;
+        node->next = alignedNode;
+        node->size = gap - sizeof(Node);
+    }
+
+    arena->manager->release(arena, node);
+    return alignedNode;
+}
+
+/**
+ * Support function for aligned allocation that frees whatever is left of an aligned node after the requested bytes,
+ * if it is big enough to be a node or compact block of its own, joining it to any free neighbour after it.
+ *
+ * @param arena - arena the node is in
+ * @param node - aligned node or compact block to be trimmed
+ * @param bytes - requested bytes to be allocated
+ */
+static void alignBack(Arena *arena, Node *node, size_t bytes)
+{
+    Node *tail;
+
+    if (arena->manager->fit == &compactFitNode)
+    {
+        size_t need = (bytes + 2 * sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+        if (need < COMPACT_MINIMUM) need = COMPACT_MINIMUM;
+        if (COMPACT_SIZE(node) < need + COMPACT_MINIMUM) return;
+
+        tail = (Node *)((void *)(node) + need);
+        COMPACT_HEADER(tail) = COMPACT_SIZE(node) - need;
+        COMPACT_HEADER(node) = need | (COMPACT_HEADER(node) & COMPACT_PREV_FREE);
+    }
+    else
+    {
+        bytes = indexedSize(arena, bytes);
+        if (node->size < bytes + sizeof(Node) + arena->manager->minimumSize) return;
+
+        tail = freeNode(node, bytes)->next;
+        tail->free = false; // Released below so that it is joined to the node after it
+    }
+
+    arena->manager->release(arena, tail);
+}
+
+/**
+ * Searches an arena for a node whose memory starts on the alignment. The algorithm is asked for enough extra bytes
+ * that an aligned address with room for a node in front of it is always inside what it finds, then the gap in front
+ * and the space after the request are freed again. Buddy blocks can't be split at arbitrary addresses, so unless a
+ * buddy block already happens to be aligned a bigger one is taken and the memory handed out from an aligned address
+ * inside it, behind a NODE_INTERIOR header pointing back to the block's real node. The caller must hold the lock.
+ *
+ * @param arena - arena to be searched
+ * @param bytes - requested bytes to be allocated
+ * @param alignment - power of two the memory address must be a multiple of
+ * @return - allocated node/NULL if can't be allocated
+ */
+static Node *alignedFitNode(Arena *arena, size_t bytes, size_t alignment)
+{
+    MemoryManager *manager = arena->manager;
+    size_t lead = (manager->fit == &compactFitNode) ? COMPACT_MINIMUM : sizeof(Node) + manager->minimumSize;
+
+    if (manager->fit == &buddyFitNode)
+    {
+        Node *node = buddyFitNode(arena, bytes);
+        if (node == NULL || ((size_t)(node) + sizeof(Node)) % alignment == 0) return node;
+        buddyRelease(arena, node);
+
+        /* Room for the real node, the interior header and the request from wherever the alignment falls */
+        if (bytes > ~(size_t)(0) - alignment - sizeof(Node)) return NULL;
+        node = buddyFitNode(arena, bytes + alignment + sizeof(Node));
+        if (node == NULL) return NULL;
+
+        size_t memory = ((size_t)(node) + 2 * sizeof(Node) + alignment - 1) & ~(alignment - 1);
+        Node *interior = (Node *)(memory - sizeof(Node));
+
+        interior->free = false;
+        interior->flags = NODE_INTERIOR;
+        interior->size = (size_t)(node) + sizeof(Node) + node->size - memory;
+        interior->prev = node;
+        interior->next = NULL;
+        return interior;
+    }
+
+    if (bytes > ~(size_t)(0) - alignment - 2 * lead) return NULL; // Would overflow once padded
+    if (manager->fit != &compactFitNode) bytes = indexedSize(arena, bytes); // Once freed the node must hold its links
+    else if (bytes < COMPACT_MINIMUM) bytes = COMPACT_MINIMUM; // Keeps what is left after the gap a whole block
+
+    Node *node = manager->fit(arena, bytes + alignment + lead);
+    if (node == NULL) return NULL;
+
+    size_t memory = (size_t)(node) + manager->headerSize;
+    size_t gap = ((memory + alignment - 1) & ~(alignment - 1)) - memory;
+    if (gap != 0)
+    {
+        while (gap < lead) gap += alignment; // The gap must be big enough to be freed
+        node = alignFront(arena, node, gap);
+    }
+    alignBack(arena, node, bytes);
+
+    return handOut(arena, node);
+}
+
+/**
+ * Allocates memory starting on an alignment, locking an arena to search it and trying the other arenas if it can't
+ * hold the request. Thread caches and the small block tier are passed over as their blocks aren't aligned.
+ *
+ * @param manager - heap to allocate from
+ * @param bytes - requested bytes to be allocated
+ * @param alignment - power of two the memory address must be a multiple of
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+static void *lockedAlignedFit(MemoryManager *manager, size_t bytes, size_t alignment)
+{
+    if (bytes < 1 || manager == NULL || alignment == 0 || (alignment & (alignment - 1)) != 0) return NULL;
+    if (alignment < sizeof(size_t)) alignment = sizeof(size_t); // Keeps the nodes of the indexed algorithms aligned
+
+    Arena *arena = lockArena(manager);
+    Node *node = alignedFitNode(arena, bytes, alignment);
+    if (node == NULL && drainPending(arena) == true) node = alignedFitNode(arena, bytes, alignment);
+    lockRelease(&arena->lock);
+
+    for (size_t i = 1; node == NULL && i < manager->arenaCount; i++)
+    {
+        Arena *other = &manager->arenas[(size_t)(arena - manager->arenas + i) % manager->arenaCount];
+
+        lockAcquire(&other->lock);
+        node = alignedFitNode(other, bytes, alignment);
+        if (node == NULL && drainPending(other) == true) node = alignedFitNode(other, bytes, alignment);
+        lockRelease(&other->lock);
+    }
+
+    if (node == NULL && manager->growable == true)
+    {
+        size_t padded = bytes + alignment + 2 * (sizeof(Node) + manager->minimumSize); // What alignedFitNode asks for
+
+        arena = lockArena(manager);
+        node = alignedFitNode(arena, bytes, alignment);
+        if (node == NULL && padded > bytes && growArena(arena, padded) == true)
+        {
+            node = alignedFitNode(arena, bytes, alignment);
+        }
+        lockRelease(&arena->lock);
+    }
+
+    if (node == NULL) return NULL;
+    return (void *)((void *)(node) + manager->headerSize);
+}
+
+/**
+ * Returns the calling thread's cache for a heap, creating it on first use.
+ *
+ * @param manager - heap the cache is for
+ * @return - the thread's cache/NULL if one can't be created
+ */
+static ThreadCache *threadCache(MemoryManager *manager)
+{
+    ThreadCache *cache = pthread_getspecific(manager->cacheKey);
+
+    if (cache == NULL)
+    {
+        cache = calloc(1, sizeof(ThreadCache));
+        if (cache == NULL) return NULL;
+
+        cache->manager = manager;
+        pthread_mutex_lock(&manager->cacheLock);
+        cache->next = manager->caches;
+        if (manager->caches != NULL) manager->caches->prev = cache;
+        manager->caches = cache;
+        pthread_mutex_unlock(&manager->cacheLock);
+
+        pthread_setspecific(manager->cacheKey, cache);
+    }
+    return cache;
+}
+
+/**
+ * Moves a batch of blocks from one size class of a cache back into the shared list, coalescing them under the lock of
+ * their arena, which is only swapped when the next block belongs to a different arena.
+ *
+ * @param cache - cache to be flushed
+ * @param class - size class to be flushed
+ * @param count - maximum number of blocks to move
+ */
+static void flushCache(ThreadCache *cache, size_t class, size_t count)
+{
+    Arena *locked = NULL;
+
+    while (count-- > 0 && cache->bins[class] != NULL)
+    {
+        Node *node = cache->bins[class];
+        Arena *arena = arenaOf(cache->manager, node);
+
+        if (arena != locked)
+        {
+            if (locked != NULL) lockRelease(&locked->lock);
+            lockAcquire(&arena->lock);
+            locked = arena;
+        }
+
+        cache->bins[class] = CACHE_LINK(node);
+        cache->counts[class]--;
+        cache->manager->release(arena, node);
+    }
+    if (locked != NULL) lockRelease(&locked->lock);
+}
+
+/**
+ * Destructor of the cache key, run when a thread exits. Every block the thread still has cached is handed back to the
+ * shared list so that it can be coalesced and used by other threads.
+ *
+ * @param memory - the exiting thread's cache
+ */
+static void drainCache(void *memory)
+{
+    ThreadCache *cache = (ThreadCache *)(memory);
+    MemoryManager *manager = cache->manager;
+
+    for (size_t class = 1; class <= CACHE_CLASSES; class++) flushCache(cache, class, cache->counts[class]);
+
+    pthread_mutex_lock(&manager->cacheLock);
+    if (cache->prev != NULL) cache->prev->next = cache->next;
+    else manager->caches = cache->next;
+    if (cache->next != NULL) cache->next->prev = cache->prev;
+    pthread_mutex_unlock(&manager->cacheLock);
+
+    free(cache);
+}
+
+/**
+ * Allocates memory through the calling thread's cache. Requests small enough to have a size class are served from the
+ * cache without locking, and when the class is empty a batch of blocks is taken from the thread's arena under one lock
+ * using the chosen algorithm. Larger requests, and requests the arena has no room for, go straight to the chosen
+ * algorithm.
+ *
+ * @param manager - heap to allocate from
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+static void *cacheAllocate(MemoryManager *manager, size_t bytes)
+{
+    size_t class = (bytes + CACHE_GRANULE - 1) / CACHE_GRANULE; // Smallest class whose blocks hold the request
+
+    if (bytes < 1) return NULL;
+    if (class > CACHE_CLASSES || (manager->smallBlocks == true && bytes <= SMALL_MAXIMUM))
+    {
+        return lockedFit(manager, manager->fit, bytes);
+    }
+
+    ThreadCache *cache = threadCache(manager);
+    if (cache == NULL) return lockedFit(manager, manager->fit, bytes);
+
+    /* Refill an empty class in a batch, stopping early if the arena runs out of room */
+    if (cache->bins[class] == NULL)
+    {
+        Arena *arena = lockArena(manager);
+        for (size_t i = 0; i < CACHE_BATCH; i++)
+        {
+            Node *node = manager->fit(arena, class * CACHE_GRANULE);
+            if (node == NULL) break;
+
+            node->flags &= ~NODE_ZEROED; // Its memory now holds the link
+            CACHE_LINK(node) = cache->bins[class];
+            cache->bins[class] = node;
+            cache->counts[class]++;
+        }
+        lockRelease(&arena->lock);
+
+        if (cache->bins[class] == NULL) return lockedFit(manager, manager->fit, bytes);
+    }
+
+    Node *node = cache->bins[class];
+    cache->bins[class] = CACHE_LINK(node);
+    cache->counts[class]--;
+
+    return (void *)((void *)(node) + sizeof(Node));
+}
+
+/**
+ * Allocates memory through the calling thread's cache of the heap set up by initialise.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *cachedAllocate(size_t bytes)
+{
+    if (defaultManager == NULL) return NULL;
+    return cacheAllocate(defaultManager, bytes);
+}
+
+/**
+ * Places a node being deallocated into the calling thread's cache if it is small enough to have a size class. A node
+ * is cached under the largest class it can hold so that it always fits requests of that class. Once a class grows
+ * past its limit half of it is flushed back to the shared list.
+ *
+ * @param manager - heap the node is in
+ * @param node - the node to be unallocated
+ * @return - true if the node was cached/false if it must be coalesced instead
+ */
+static bool_type cacheNode(MemoryManager *manager, Node *node)
+{
+    size_t class = node->size / CACHE_GRANULE; // Largest class the node can hold
+
+    if (class < 1 || class > CACHE_CLASSES) return false;
+
+    ThreadCache *cache = threadCache(manager);
+    if (cache == NULL) return false;
+
+    CACHE_LINK(node) = cache->bins[class];
+    cache->bins[class] = node;
+    cache->counts[class]++;
+
+    if (cache->counts[class] > CACHE_LIMIT) flushCache(cache, class, CACHE_LIMIT / 2);
+    return true;
+}
+
+/**
+ * Finds the lock named by a lock policy, see memoryManager_lockPolicy.
+ *
+ * @param policy - name of the lock
+ * @return - LOCK_ constant of the lock, LOCK_MUTEX if the name is NULL or invalid
+ */
+static int lockPolicyOf(char *policy)
+{
+    /* Check for NULL being passed in, and default to a mutex */
+    if (policy == NULL) return LOCK_MUTEX;
+    else if (!strcmp(policy, "None")) return LOCK_NONE;
+    else if (!strcmp(policy, "Spin")) return LOCK_SPIN;
+    else if (!strcmp(policy, "Ticket")) return LOCK_TICKET;
+    else if (!strcmp(policy, "Futex")) return LOCK_FUTEX;
+    else return LOCK_MUTEX;
+}
+
+/**
+ * Enables or disables the per-thread caches for heaps set up by initialise afterwards. While enabled, allocation and
+ * deallocation serve small blocks from a cache owned by the calling thread without locking, refilling from and flushing
+ * to the shared list in batches.
+ *
+ * @param enabled - true to use the caches
+ */
+void memoryManager_threadCache(bool_type enabled)
+{
+    defaultOptions.threadCache = enabled;
+}
+
+/**
+ * Sets how many arenas heaps set up by initialise afterwards are split into, each with its own lock so that threads
+ * allocating at the same time can do so in different arenas. Heaps too small to give every arena ARENA_MINIMUM bytes
+ * use fewer. Arenas are slices of one pool, so a request no arena can hold on its own is given a block running on from
+ * the free end of one arena over the free arenas after it, which get their slices back once it is deallocated. Buddy
+ * and compact heaps and heaps with region locking keep every block inside one arena, so the largest block they can
+ * hand out is an arena less one node unless the request passes the map threshold.
+ *
+ * @param count - number of arenas, 0 is treated as 1
+ */
+void memoryManager_arenas(size_t count)
+{
+    defaultOptions.arenas = count;
+}
+
+/**
+ * Enables or disables the small block tier for heaps set up by initialise afterwards. While enabled, part of each heap
+ * big enough is set aside as chunks of up to SMALL_MAXIMUM bytes without nodes, which requests that small are served
+ * from first.
+ *
+ * @param enabled - true to use the small block tier
+ */
+void memoryManager_smallBlocks(bool_type enabled)
+{
+    defaultOptions.smallBlocks = enabled;
+}
+
+/**
+ * Declares whether the memory given to heaps set up by initialise afterwards is all zero, such as memory from calloc or
+ * a fresh mapping. Blocks of such a heap that have never been deallocated are then not cleared again by callocate.
+ *
+ * @param zeroed - true if the memory is all zero
+ */
+void memoryManager_zeroedMemory(bool_type zeroed)
+{
+    defaultOptions.zeroedMemory = zeroed;
+}
+
+/**
+ * Enables or disables growing for heaps set up by initialise afterwards. Once a growable heap has no room for a request
+ * it maps a segment of new memory and carries on, so it can be created in a small buffer. Buddy and compact heaps
+ * depend on their blocks being contiguous and never grow.
+ *
+ * @param enabled - true to map segments once full
+ */
+void memoryManager_growable(bool_type enabled)
+{
+    defaultOptions.growable = enabled;
+}
+
+/**
+ * Sets the size of free node from which heaps set up by initialise afterwards give whole pages back to the operating
+ * system as memory is deallocated, so that the memory they use drops once it is no longer needed. The pages are zero
+ * when they are next used, which callocate takes advantage of. Only memory the heap mapped itself, through
+ * initialise_mapped or by growing, is trimmed, and compact heaps are never trimmed.
+ *
+ * @param bytes - size of free node in bytes, 0 to never trim as memory is deallocated
+ */
+void memoryManager_trimThreshold(size_t bytes)
+{
+    defaultOptions.trimThreshold = bytes;
+}
+
+/**
+ * Sets the size of request from which heaps set up by initialise afterwards give each block a mapping of its own
+ * instead of taking it from an arena. Such blocks are unmapped as soon as they are deallocated and resized by remapping
+ * them, without copying. Aligned requests and compact heaps always use the arenas.
+ *
+ * @param bytes - size of request in bytes, 0 to never map blocks
+ */
+void memoryManager_mapThreshold(size_t bytes)
+{
+    defaultOptions.mapThreshold = bytes;
+}
+
+/**
+ * Enables or disables deferred coalescing for heaps set up by initialise afterwards. While enabled, deallocation only
+ * pushes the block onto a lock-free stack of its arena, and the blocks are released and coalesced in bulk once an
+ * allocation can't find room or the sweeper runs.
+ *
+ * @param enabled - true to defer coalescing
+ */
+void memoryManager_deferredCoalescing(bool_type enabled)
+{
+    defaultOptions.deferredCoalescing = enabled;
+}
+
+/**
+ * Sets how often a background thread of each heap with deferred coalescing set up by initialise afterwards releases its
+ * pending blocks.
+ *
+ * @param milliseconds - time between sweeps, 0 for no sweeper
+ */
+void memoryManager_sweeper(unsigned int milliseconds)
+{
+    defaultOptions.sweepInterval = milliseconds;
+}
+
+/**
+ * Chooses the lock guarding each arena of heaps set up by initialise afterwards. "Mutex" uses a pthread mutex, "None"
+ * no lock at all for heaps that only one thread ever uses, "Spin" a test and test and set spinlock with exponential
+ * backoff, "Ticket" a fair ticket lock and "Futex" a mutex that spins before sleeping. If an invalid one is chosen, a
+ * mutex is used by default. part3_bench compares them at different numbers of threads.
+ *
+ * @param policy - name of the lock to be used
+ */
+void memoryManager_lockPolicy(char *policy)
+{
+    static char *names[] = {"Mutex", "None", "Spin", "Ticket", "Futex"}; // Kept rather than the caller's string
+    defaultOptions.lockPolicy = names[lockPolicyOf(policy)];
+}
+
+/**
+ * Enables or disables flat combining for heaps set up by initialise afterwards. While enabled, threads publish their
+ * allocations and deallocations in slots of their own, and whichever thread gets an arena's lock carries out every
+ * waiting request in one go, rather than the lock and the arena's list being passed from thread to thread one request
+ * at a time.
+ *
+ * @param enabled - true to combine requests
+ */
+void memoryManager_flatCombining(bool_type enabled)
+{
+    defaultOptions.flatCombining = enabled;
+}
+
+/**
+ * Enables or disables lock-free size classes for heaps set up by initialise afterwards. While enabled, requests small
+ * enough to have a size class are served from a lock-free stack shared by every thread, and deallocated blocks of a
+ * class are pushed back onto it, so only refilling an empty class takes a lock. The stacks are emptied back into the
+ * lists when the heap runs out of room or is trimmed.
+ *
+ * @param enabled - true to use the size classes
+ */
+void memoryManager_lockFreeClasses(bool_type enabled)
+{
+    defaultOptions.lockFreeClasses = enabled;
+}
+
+/**
+ * Enables or disables remote frees for heaps set up by initialise afterwards. While enabled, a thread deallocating a
+ * block from an arena other than its own pushes it onto that arena's lock-free queue instead of taking the arena's
+ * lock, and the thread that owns the arena releases the queue on its next allocation, so producer and consumer threads
+ * don't wait on each other. Threads own the arena they were first given for good, only borrowing others while theirs is
+ * busy, so the heap needs more than one arena for frees to be remote.
+ *
+ * @param enabled - true to queue remote frees
+ */
+void memoryManager_remoteFrees(bool_type enabled)
+{
+    defaultOptions.remoteFrees = enabled;
+}
+
+/**
+ * Enables or disables region locking for first fit and next fit heaps set up by initialise afterwards. While enabled,
+ * each arena's list is split into REGION_LOCKS address ranges with a lock each, of the kind chosen by
+ * memoryManager_lockPolicy. Searches walk the list with lock coupling and deallocation locks only the regions of the
+ * node and its neighbours, so threads working in different parts of a big heap run side by side. Anything that works on
+ * a whole list, such as aligned allocation or trimming, still locks the arena as a whole. Heaps with region locking
+ * don't grow.
+ *
+ * @param enabled - true to lock regions
+ */
+void memoryManager_regionLocking(bool_type enabled)
+{
+    defaultOptions.regionLocking = enabled;
+}
+
+/**
+ * Shared body of mm_create_ex and mm_create_mapped_ex that sets up a heap in the given memory. The first node of each
+ * arena is a hole that takes up the entire arena.
+ *
+ * @param memory - pointer to heap
+ * @param size - size of heap in bytes
+ * @param algorithm - the algorithm to be used
+ * @param options - settings of the heap
+ * @param zeroed - whether the memory is all zero
+ * @return - the new heap/NULL if it can't be created
+ */
+static MemoryManager *createHeap(void *memory, size_t size, char *algorithm, const MemoryOptions *options,
+                                 bool_type zeroed)
+{
+    if (memory == NULL || size <= sizeof(Node)) return NULL;
+
+    MemoryManager *manager = calloc(1, sizeof(MemoryManager));
+    if (manager == NULL) return NULL;
+
+    /* Check for NULL being passed in, and default to firstFit */
+    if (algorithm == NULL) manager->allocate = &firstFit, manager->fit = &firstFitNode;
+    else if (!strcmp(algorithm, "BestFit")) manager->allocate = &bestFit, manager->fit = &bestFitNode;
+    else if (!strcmp(algorithm, "WorstFit")) manager->allocate = &worstFit, manager->fit = &worstFitNode;
+    else if (!strcmp(algorithm, "NextFit")) manager->allocate = &nextFit, manager->fit = &nextFitNode;
+    else if (!strcmp(algorithm, "SegregatedFit")) manager->allocate = &segregatedFit, manager->fit = &segregatedFitNode;
+    else if (!strcmp(algorithm, "TLSF")) manager->allocate = &tlsfFit, manager->fit = &tlsfFitNode;
+    else if (!strcmp(algorithm, "Buddy")) manager->allocate = &buddyFit, manager->fit = &buddyFitNode;
+    else if (!strcmp(algorithm, "Compact")) manager->allocate = &compactFit, manager->fit = &compactFitNode;
+    else manager->allocate = &firstFit, manager->fit = &firstFitNode; // If anything else, default to firstFit.
+
+    /* Segregated fit, TLSF, best fit and worst fit keep an index of their free nodes */
+    manager->minimumSize = 1;
+    manager->headerSize = sizeof(Node);
+    manager->release = &releaseNode;
+    if (manager->fit == &segregatedFitNode)
+    {
+        manager->indexInsert = &segregatedInsert;
+        manager->indexRemove = &segregatedRemove;
+        manager->minimumSize = sizeof(FreeLinks);
+    }
+    else if (manager->fit == &tlsfFitNode)
+    {
+        manager->indexInsert = &tlsfInsert;
+        manager->indexRemove = &tlsfRemove;
+        manager->minimumSize = sizeof(FreeLinks);
+    }
+    else if (manager->fit == &bestFitNode)
+    {
+        manager->indexInsert = &treeInsert;
+        manager->indexRemove = &treeRemove;
+        manager->minimumSize = sizeof(TreeLinks);
+    }
+    else if (manager->fit == &worstFitNode)
+    {
+        manager->indexInsert = &heapInsert;
+        manager->indexRemove = &heapRemove;
+        manager->minimumSize = sizeof(HeapLinks);
+    }
+    else if (manager->fit == &buddyFitNode) manager->release = &buddyRelease; // Buddy blocks are merged by the algorithm
+    else if (manager->fit == &compactFitNode)
+    {
+        manager->release = &compactRelease;
+        manager->headerSize = sizeof(size_t);
+    }
+
+    if (options->smallBlocks == true) size = smallSetup(manager, memory, size);
+
+    /* Split the heap into arenas, using fewer of them if the heap is too small */
+    size_t count = (options->arenas == 0) ? 1 : options->arenas;
+    int lockPolicy = lockPolicyOf(options->lockPolicy);
+    while (count > 1 && size / count < ARENA_MINIMUM) count--;
+
+    manager->arenas = calloc(count, sizeof(Arena)); // Every index starts empty
+    if (manager->arenas == NULL || pthread_key_create(&manager->arenaKey, NULL) != 0)
+    {
+        free(manager->smallClasses[SMALL_CLASSES - 1].bitmap);
+        free(manager->arenas);
+        free(manager);
+        return NULL;
+    }
+    manager->arenaCount = count;
+    manager->arenaSpan = (size / count) & ~(sizeof(size_t) - 1); // Keeps the nodes of every arena aligned
+    manager->arenaEnd = memory + size;
+
+    manager->threadCaching = (manager->fit == &compactFitNode) ? false : options->threadCache; // Caches need nodes
+    manager->regionLocking = (manager->fit == &firstFitNode || manager->fit == &nextFitNode) ? options->regionLocking
+                                                                                             : false;
+    manager->regionFromLast = (manager->fit == &nextFitNode) ? true : false;
+
+    /* Region locks are split out of one block, segments would lie outside of every region */
+    ArenaLock *regionLocks = NULL;
+    if (manager->regionLocking == true) regionLocks = calloc(count * (REGION_LOCKS + 1), sizeof(ArenaLock));
+    if (regionLocks == NULL) manager->regionLocking = false;
+
+    manager->growable = (manager->release == &releaseNode && manager->regionLocking == false) ? options->growable
+                                                                                              : false;
+    if (count > 1 && manager->release == &releaseNode && manager->regionLocking == false) manager->spanning = true;
+    manager->trimThreshold = (manager->fit == &compactFitNode) ? 0 : options->trimThreshold;
+    manager->mapThreshold = (manager->fit == &compactFitNode) ? 0 : options->mapThreshold;
+    manager->deferred = options->deferredCoalescing;
+    if (manager->threadCaching == true && pthread_key_create(&manager->cacheKey, &drainCache) != 0)
+    {
+        pthread_key_delete(manager->arenaKey);
+        free(regionLocks);
+        free(manager->smallClasses[SMALL_CLASSES - 1].bitmap);
+        free(manager->arenas);
+        free(manager);
+        return NULL;
+    }
+    manager->lockFreeClasses = (manager->fit == &compactFitNode) ? false : options->lockFreeClasses; // Links need nodes
+    manager->remoteFrees = options->remoteFrees;
+    manager->combining = options->flatCombining;
+    if (manager->combining == true && pthread_key_create(&manager->combineKey, &releaseSlot) != 0)
+    {
+        manager->combining = false; // The heap works the same without it, just with each thread taking the lock
+    }
+    pthread_mutex_init(&manager->cacheLock, NULL);
+    pthread_mutex_init(&manager->mapLock, NULL);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Arena *arena = &manager->arenas[i];
+        size_t arenaSize = (i == count - 1) ? size - i * manager->arenaSpan : manager->arenaSpan;
+        Node *node = (Node *)(memory + i * manager->arenaSpan); // Assign struct to start of arena
+
+        arena->manager = manager;
+        arena->firstBlock = arena->lastUsed = node; // Sets up lastUsed in all cases for readability
+        lockInit(&arena->lock, (manager->regionLocking == true) ? LOCK_SHARED : lockPolicy);
+
+        if (manager->regionLocking == true)
+        {
+            arena->regionLocks = regionLocks + i * (REGION_LOCKS + 1);
+            arena->regionSpan = arenaSize / REGION_LOCKS + 1;
+            for (size_t j = 0; j <= REGION_LOCKS; j++) lockInit(&arena->regionLocks[j], lockPolicy);
+        }
+
+        if (manager->fit == &compactFitNode)
+        {
+            compactSplitHeap(arena, arenaSize);
+            continue;
+        }
+
+        node->free = true;
+        node->flags = (zeroed == true) ? NODE_SEGMENT | NODE_ZEROED : NODE_SEGMENT;
+        node->size = arenaSize - sizeof(Node); // Initialises size to not include the size of the struct
+        node->next = node;
+        node->prev = node;
+
+        if (manager->fit == &buddyFitNode) buddySplitHeap(arena, arenaSize);
+        else if (manager->indexInsert != NULL) manager->indexInsert(arena, node);
+    }
+
+    /* The heap works the same without a sweeper, pending blocks are just left until an allocation needs them */
+    pthread_mutex_init(&manager->sweepLock, NULL);
+    pthread_cond_init(&manager->sweepCond, NULL);
+    if (manager->deferred == true && options->sweepInterval != 0 && lockPolicy != LOCK_NONE) // A sweeper is a thread
+    {
+        manager->sweepInterval = options->sweepInterval;
+        manager->sweeping = true;
+        if (pthread_create(&manager->sweeper, NULL, &sweep, manager) != 0) manager->sweepInterval = 0;
+    }
+
+    return manager;
+}
+
+/**
+ * Creates a heap in the given memory that is independent of every other heap, with its own algorithm, arenas and
+ * locks. Using the algorithm parameter the search of the heap is chosen - if an invalid one is chosen, first fit is
+ * chosen by default. The number of arenas, the lock guarding them and every other feature of the heap are taken from
+ * the options, which are only read while the heap is created. Blocks can run across arenas, see memoryManager_arenas.
+ *
+ * @param memory - pointer to heap
+ * @param size - size of heap in bytes
+ * @param algorithm - the algorithm to be used
+ * @param options - settings of the heap, NULL for the defaults
+ * @return - the new heap/NULL if it can't be created
+ */
+MemoryManager *mm_create_ex(void *memory, size_t size, char *algorithm, const MemoryOptions *options)
+{
+    static const MemoryOptions defaults = {0};
+    if (options == NULL) options = &defaults;
+    return createHeap(memory, size, algorithm, options, options->zeroedMemory);
+}
+
+/**
+ * Creates a heap like mm_create_ex with the default options.
+ *
+ * @param memory - pointer to heap
+ * @param size - size of heap in bytes
+ * @param algorithm - the algorithm to be used
+ * @return - the new heap/NULL if it can't be created
+ */
+MemoryManager *mm_create(void *memory, size_t size, char *algorithm)
+{
+    return mm_create_ex(memory, size, algorithm, NULL);
+}
+
+/**
+ * Maps memory for a heap backed by huge pages so that walking its nodes needs far fewer TLB entries. Reserved huge
+ * pages are used if there are any, and otherwise normal pages are mapped on a huge page boundary and the kernel is
+ * asked to back them with transparent huge pages.
+ *
+ * @param size - size of heap in bytes, which is a multiple of HUGE_PAGE_SIZE
+ * @return - the mapped memory/NULL if none could be mapped
+ */
+static void *mapHeap(size_t size)
+{
+#ifdef MAP_HUGETLB
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) return memory;
+#endif
+
+    /* Map a huge page more than needed and unmap what lies either side of the first boundary */
+    void *mapping = mmap(NULL, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return NULL;
+
+    void *aligned = (void *)(((size_t)(mapping) + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1));
+    if (aligned != mapping) munmap(mapping, (size_t)(aligned - mapping));
+    munmap(aligned + size, (size_t)(mapping + HUGE_PAGE_SIZE - aligned));
+
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, size, MADV_HUGEPAGE); // Only a hint, the heap works the same without it
+#endif
+    return aligned;
+}
+
+/**
+ * Creates a heap like mm_create_ex in memory that it maps for itself, backed by huge pages where the system allows it,
+ * and unmaps again when it is destroyed. The size is rounded up to a whole number of huge pages. The memory is always
+ * known to be zero, whatever the options say.
+ *
+ * @param size - size of heap in bytes
+ * @param algorithm - the algorithm to be used
+ * @param options - settings of the heap, NULL for the defaults
+ * @return - the new heap/NULL if it can't be created
+ */
+MemoryManager *mm_create_mapped_ex(size_t size, char *algorithm, const MemoryOptions *options)
+{
+    static const MemoryOptions defaults = {0};
+    if (options == NULL) options = &defaults;
+    if (size == 0 || size > ~(size_t)(0) - 2 * HUGE_PAGE_SIZE) return NULL;
+    size = (size + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1);
+
+    void *memory = mapHeap(size);
+    if (memory == NULL) return NULL;
+
+    MemoryManager *manager = createHeap(memory, size, algorithm, options, true);
+    if (manager == NULL)
+    {
+        munmap(memory, size);
+        return NULL;
+    }
+
+    manager->mapping = memory;
+    manager->mappingSize = size;
+    return manager;
+}
+
+/**
+ * Creates a heap like mm_create_mapped_ex with the default options.
+ *
+ * @param size - size of heap in bytes
+ * @param algorithm - the algorithm to be used
+ * @return - the new heap/NULL if it can't be created
+ */
+MemoryManager *mm_create_mapped(size_t size, char *algorithm)
+{
+    return mm_create_mapped_ex(size, algorithm, NULL);
+}
+
+/**
+ * Allocates memory from a heap created by mm_create using the heap's algorithm, going through the calling thread's
+ * cache if the heap has them.
+ *
+ * @param manager - heap to allocate from
+ * @param bytes - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *mm_allocate(MemoryManager *manager, size_t bytes)
+{
+    if (manager == NULL) return NULL;
+    if (manager->threadCaching == true) return cacheAllocate(manager, bytes);
+    return lockedFit(manager, manager->fit, bytes);
+}
+
+/**
+ * Allocates memory from a heap created by mm_create whose address is a multiple of the alignment, such as a cache
+ * line or a page, using the heap's algorithm. The memory is deallocated with mm_deallocate as normal.
+ *
+ * @param manager - heap to allocate from
+ * @param bytes - requested bytes to be allocated
+ * @param alignment - power of two the memory address must be a multiple of
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *mm_allocate_aligned(MemoryManager *manager, size_t bytes, size_t alignment)
+{
+    return lockedAlignedFit(manager, bytes, alignment);
+}
+
+/**
+ * Allocates a number of blocks from a heap created by mm_create while taking the lock of an arena only once. Small
+ * requests are served by the small block tier if the heap has one, and only a request the arena can't hold lets go
+ * of the lock so that the other arenas can be searched. The thread caches are not used.
+ *
+ * @param manager - heap to allocate from
+ * @param sizes - requested bytes of each block
+ * @param count - number of blocks
+ * @param memory - array the memory pointers are written to, with NULL for any that can't be allocated
+ * @return - number of blocks allocated
+ */
+size_t mm_allocate_batch(MemoryManager *manager, size_t *sizes, size_t count, void **memory)
+{
+    Arena *arena = NULL;
+    size_t allocated = 0;
+
+    if (manager == NULL) return 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        memory[i] = NULL;
+        if (sizes[i] < 1) continue;
+
+        if (manager->smallBlocks == true && sizes[i] <= SMALL_MAXIMUM) memory[i] = smallAllocate(manager, sizes[i]);
+        if (memory[i] == NULL && manager->mapThreshold != 0 && sizes[i] >= manager->mapThreshold)
+        {
+            memory[i] = mapBlock(manager, sizes[i]);
+        }
+        else if (memory[i] == NULL)
+        {
+            if (arena == NULL) arena = lockArena(manager);
+
+            Node *node = manager->fit(arena, sizes[i]);
+            if (node != NULL) memory[i] = (void *)((void *)(node) + manager->headerSize);
+            else
+            {
+                lockRelease(&arena->lock); // Let the other arenas be searched
+                arena = NULL;
+                memory[i] = lockedFit(manager, manager->fit, sizes[i]);
+            }
+        }
+
+        if (memory[i] != NULL) allocated++;
+    }
+
+    if (arena != NULL) lockRelease(&arena->lock);
+    return allocated;
+}
+
+/**
+ * Moves back from a memory pointer to the node of the block it was handed out from, or its header if compact. Aligned
+ * buddy memory may sit inside its block behind an interior header, which points back to the real node.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointer to be looked up
+ * @return - node of the block
+ */
+static Node *blockNode(MemoryManager *manager, void *memory)
+{
+    Node *node = (Node *)(memory - manager->headerSize);
+
+    if (manager->fit == &buddyFitNode && (node->flags & NODE_INTERIOR) != 0) return node->prev;
+    return node;
+}
+
+/**
+ * Deallocate memory from a heap created by mm_create by handing its node to the calling thread's cache, or, if it
+ * can't be cached, locking the arena the node is in and coalescing it with any free neighbours. Heaps with deferred
+ * coalescing leave the node pending without locking instead, while heaps with flat combining have the lock holder
+ * coalesce it. Heaps with lock-free size classes push small nodes onto their class instead, heaps with remote frees
+ * leave nodes from another thread's arena pending for that thread and heaps with region locking only lock the regions
+ * of the node and its neighbours. Blocks with a mapping of their own are unmapped.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointer to be unallocated
+ */
+void mm_deallocate(MemoryManager *manager, void *memory)
+{
+    Node *node = (Node *)(memory); // Get node pointer from memory pointer
+    if(node == NULL || manager == NULL) return; // Make sure that the input is a valid pointer
+    if (smallFree(manager, memory) == true) return;
+    node = blockNode(manager, memory); // Moves back to the actual node struct, or header if compact
+
+    if (isMapped(manager, memory) == true)
+    {
+        unmapBlock(manager, node);
+        return;
+    }
+
+    if (manager->threadCaching == true && cacheNode(manager, node) == true) return;
+    if (manager->lockFreeClasses == true && classFree(manager, node) == true) return;
+    if (manager->deferred == true && deferNode(manager, node) == true) return;
+    if (manager->remoteFrees == true && remoteFree(manager, node) == true) return;
+    if (manager->combining == true)
+    {
+        combine(manager, NULL, 0, node);
+        return;
+    }
+    if (manager->regionLocking == true)
+    {
+        regionRelease(arenaOf(manager, node), node);
+        return;
+    }
+
+    Arena *arena = arenaOf(manager, node);
+    lockAcquire(&arena->lock);
+    manager->release(arena, node);
+    lockRelease(&arena->lock);
+}
+
+/**
+ * Support function for qsort that orders memory pointers by address.
+ *
+ * @param first - pointer to the first memory pointer
+ * @param second - pointer to the second memory pointer
+ * @return - negative, zero or positive as the first address is below, equal to or above the second
+ */
+static int compareAddresses(const void *first, const void *second)
+{
+    size_t a = (size_t)(*(void **)(first));
+    size_t b = (size_t)(*(void **)(second));
+    return (a > b) - (a < b);
+}
+
+/**
+ * Deallocates a number of blocks from a heap created by mm_create while taking the lock of each arena involved only
+ * once. A copy of the pointers is sorted by address first, so the blocks of an arena come one after another and any
+ * that are next to each other are joined into one node in a single pass before being released. If there is no room for
+ * the copy the blocks are released in the order given, which only takes the locks more often. The thread caches are not
+ * used.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointers to be unallocated, which are left as they are/NULL entries are skipped
+ * @param count - number of pointers
+ */
+void mm_deallocate_batch(MemoryManager *manager, void **memory, size_t count)
+{
+    void *local[BATCH_STACK];
+    void **sorted = local;
+
+    if (manager == NULL) return;
+    if (count > BATCH_STACK)
+    {
+        sorted = (count <= ~(size_t)(0) / sizeof(void *)) ? malloc(count * sizeof(void *)) : NULL;
+        if (sorted == NULL) sorted = memory; // Still correct unsorted, runs just aren't found across the array
+    }
+    if (sorted != memory)
+    {
+        memcpy(sorted, memory, count * sizeof(void *));
+        qsort(sorted, count, sizeof(void *), &compareAddresses);
+    }
+
+    size_t i = 0;
+    while (i < count)
+    {
+        if (sorted[i] == NULL || smallFree(manager, sorted[i]) == true)
+        {
+            i++;
+            continue;
+        }
+        if (isMapped(manager, sorted[i]) == true)
+        {
+            unmapBlock(manager, (Node *)(sorted[i] - sizeof(Node)));
+            i++;
+            continue;
+        }
+
+        Arena *arena = arenaOf(manager, blockNode(manager, sorted[i]));
+        lockAcquire(&arena->lock);
+
+        /* Release blocks until the next one is in another arena, the small block tier or a mapping of its own */
+        do
+        {
+            Node *node = blockNode(manager, sorted[i]);
+            i++;
+
+            /* Join runs of blocks that are next to each other so that each run is released, and indexed, once */
+            while (manager->release == &releaseNode && i < count && (node->next->flags & NODE_SEGMENT) == 0 &&
+                   sorted[i] == (void *)(node->next) + sizeof(Node))
+            {
+                Node *next = node->next;
+                if (arena->lastUsed == next) arena->lastUsed = node;
+
+                node->next = next->next;
+                next->next->prev = node;
+                node->size += next->size + sizeof(Node);
+                i++;
+            }
+
+            manager->release(arena, node);
+        }
+        while (i < count && smallClassOf(manager, sorted[i]) == NULL && isMapped(manager, sorted[i]) == false &&
+               arenaOf(manager, blockNode(manager, sorted[i])) == arena);
+
+        lockRelease(&arena->lock);
+    }
+
+    if (sorted != local && sorted != memory) free(sorted);
+}
+
+/**
+ * Finds how many bytes can be used in a block allocated from a heap created by mm_create, which may be more than was
+ * requested as blocks are rounded up and nodes too small to split off are handed out whole.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointer to be looked up
+ * @return - usable bytes of the block/0 if memory is NULL
+ */
+size_t mm_usable_size(MemoryManager *manager, void *memory)
+{
+    if (memory == NULL || manager == NULL) return 0;
+
+    SmallClass *small = smallClassOf(manager, memory);
+    if (small != NULL) return small->chunkSize;
+
+    Node *node = (Node *)(memory - manager->headerSize);
+    if (manager->fit == &compactFitNode) return COMPACT_SIZE(node) - sizeof(size_t);
+    return node->size;
+}
+
+/**
+ * Gives the whole pages inside every free node of a heap created by mm_create back to the operating system, however
+ * big the node is, locking one arena at a time and releasing any pending blocks and blocks in lock-free size classes
+ * first. Only memory the heap mapped itself, through mm_create_mapped or by growing, is trimmed, and compact heaps
+ * aren't trimmed.
+ *
+ * @param manager - heap to be trimmed
+ * @return - bytes given back
+ */
+size_t mm_trim(MemoryManager *manager)
+{
+    size_t trimmed = 0;
+
+    if (manager == NULL || manager->fit == &compactFitNode) return 0;
+    if (manager->lockFreeClasses == true) drainClasses(manager); // So that the blocks in them can be coalesced
+
+    for (size_t i = 0; i < manager->arenaCount; i++)
+    {
+        Arena *arena = &manager->arenas[i];
+
+        lockAcquire(&arena->lock);
+        drainPending(arena); // Pending blocks would be trimmed as soon as they were released anyway
+        Node *node = arena->firstBlock; // Blocks spanning arenas move the first node
+        do
+        {
+            if (node->free == true) trimmed += trimNode(manager, node, node, (void *)(node) + sizeof(Node) + node->size);
+            node = node->next;
+        }while(node != arena->firstBlock);
+        lockRelease(&arena->lock);
+    }
+
+    return trimmed;
+}
+
+/**
+ * Counts the requests of a heap with flat combining that were carried out by a combiner for another thread, rather
+ * than by the thread that made them. The count is read without locking, so it may miss requests still being served.
+ *
+ * @param manager - heap to be looked up
+ * @return - requests carried out for other threads
+ */
+size_t mm_combined(MemoryManager *manager)
+{
+    size_t combined = 0;
+
+    for (size_t i = 0; manager != NULL && i < manager->arenaCount; i++)
+    {
+        combined += __atomic_load_n(&manager->arenas[i].combined, __ATOMIC_RELAXED);
+    }
+    return combined;
+}
+
+/**
+ * Counts the requests of a heap with region locking that were carried out holding only the shared side of an arena's
+ * lock and the locks of the regions involved, rather than falling back to the whole arena's lock. The count is read
+ * without locking, so it may miss requests still being served.
+ *
+ * @param manager - heap to be looked up
+ * @return - requests carried out under region locks
+ */
+size_t mm_region_served(MemoryManager *manager)
+{
+    size_t served = 0;
+
+    for (size_t i = 0; manager != NULL && manager->regionLocking == true && i < manager->arenaCount; i++)
+    {
+        for (size_t j = 0; j < REGION_LOCKS; j++)
+        {
+            served += __atomic_load_n(&manager->arenas[i].regionLocks[j].served, __ATOMIC_RELAXED);
+        }
+    }
+    return served;
+}
+
+/**
+ * Support function for reallocation that grows or shrinks a node in place. Growing absorbs the node after it if that
+ * node is free and big enough, and any bytes left over, like any bytes given up when shrinking, are split off into a
+ * node that is released so that it joins a free node after it. Compact blocks are resized the same way using their
+ * headers, while buddy blocks only ever shrink in place, being halved down to the smallest order that holds the bytes
+ * with each upper half released as a free buddy. Blocks spanning arenas are always moved. The caller must hold the
+ * lock.
+ *
+ * @param arena - arena the node is in
+ * @param node - allocated node or compact block to be resized
+ * @param bytes - bytes the node must hold
+ * @return - true if the node now holds the bytes/false if it must be moved
+ */
+static bool_type resizeNode(Arena *arena, Node *node, size_t bytes)
+{
+    MemoryManager *manager = arena->manager;
+
+    if (manager->fit == &buddyFitNode)
+    {
+        size_t order = buddyRequestOrder(bytes);
+
+        if (node->size < bytes) return false;
+
+        /* Halve the block down to the requested order, releasing the upper half each time */
+        for (size_t current = buddyOrder(node); current > order; current--)
+        {
+            size_t half = (size_t)(1) << (current - 1);
+            Node *buddy = (Node *)((void *)(node) + half);
+
+            buddy->free = false;
+            buddy->flags = 0;
+            buddy->size = half - sizeof(Node);
+            buddy->prev = node;
+            buddy->next = node->next;
+            node->next->prev = buddy;
+            node->next = buddy;
+            node->size = half - sizeof(Node);
+
+            manager->release(arena, buddy); // Its buddy is the block being kept, so it can't merge
+        }
+        return handOut(arena, node) != NULL;
+    }
+
+    if (manager->fit == &compactFitNode)
+    {
+        size_t need = (bytes + 2 * sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+        void *next = (void *)(node) + COMPACT_SIZE(node);
+
+        if (need < COMPACT_MINIMUM) need = COMPACT_MINIMUM;
+        if (COMPACT_SIZE(node) < need)
+        {
+            if (!(COMPACT_HEADER(next) & COMPACT_FREE) || COMPACT_SIZE(node) + COMPACT_SIZE(next) < need) return false;
+
+            compactRemove(arena, next);
+            COMPACT_HEADER(node) += COMPACT_SIZE(next);
+            COMPACT_HEADER((void *)(node) + COMPACT_SIZE(node)) &= ~(size_t)(COMPACT_PREV_FREE);
+        }
+        alignBack(arena, node, bytes);
+        return true;
+    }
+
+    if (spansArenas(arena, node) == true) return false; // Moved so that the arenas it covers are given back
+
+    bytes = indexedSize(arena, bytes);
+    if (node->size < bytes)
+    {
+        Node *nextNode = node->next;
+
+        if ((nextNode->flags & NODE_SEGMENT) != 0 || nextNode->free == false) return false;
+        if (node->size + sizeof(Node) + nextNode->size < bytes) return false;
+
+        if (arena->lastUsed == nextNode) arena->lastUsed = node; // Preserve last used for next fit
+        if (manager->indexRemove != NULL) manager->indexRemove(arena, nextNode);
+
+        node->next = nextNode->next;
+        node->size += nextNode->size + sizeof(Node);
+        nextNode->next->prev = node; // If they were the only two nodes this points node back at itself
+    }
+    alignBack(arena, node, bytes);
+    handOut(arena, node); // It may have shrunk into a size class
+    return true;
+}
+
+/**
+ * Allocates zeroed memory for an array from a heap created by mm_create, failing if the size of the array overflows.
+ * Blocks that still hold the zeroes the heap was given only have the links that were written to them while they were
+ * free cleared, while any other block is cleared in full. The thread caches are not used.
+ *
+ * @param manager - heap to allocate from
+ * @param count - number of elements
+ * @param size - size of each element in bytes
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *mm_callocate(MemoryManager *manager, size_t count, size_t size)
+{
+    if (manager == NULL) return NULL;
+    if (count != 0 && size > (size_t)(-1) / count) return NULL; // count * size would overflow
+
+    size_t bytes = count * size;
+    void *memory = lockedFit(manager, manager->fit, bytes); // Cached blocks may have been written since they were zero
+    if (memory == NULL) return NULL;
+
+    /* Small chunks and compact blocks keep no record of being zeroed */
+    if (smallClassOf(manager, memory) != NULL || manager->fit == &compactFitNode)
+    {
+        memset(memory, 0, bytes);
+        return memory;
+    }
+
+    Node *node = (Node *)(memory - sizeof(Node));
+    if ((node->flags & NODE_ZEROED) == 0)
+    {
+        memset(memory, 0, bytes);
+        return memory;
+    }
+
+    /* Only the links of the index, if it has one, were written to the memory */
+    size_t links = linkSize(manager);
+    memset(memory, 0, (links < bytes) ? links : bytes);
+    return memory;
+}
+
+/**
+ * Resizes a block allocated from a heap created by mm_create. The block is grown or shrunk in place under the lock of
+ * its arena whenever it can be, and only otherwise moved to a new block, copying no more than it held. A NULL pointer
+ * is allocated and a size of 0 deallocates.
+ *
+ * @param manager - heap the memory was allocated from
+ * @param memory - the memory pointer to be resized/NULL
+ * @param bytes - new size of the block in bytes
+ * @return - void memory pointer, which may have moved/NULL if it can't be resized, leaving the block as it was
+ */
+void *mm_reallocate(MemoryManager *manager, void *memory, size_t bytes)
+{
+    if (manager == NULL) return NULL;
+    if (memory == NULL) return mm_allocate(manager, bytes);
+    if (bytes < 1)
+    {
+        mm_deallocate(manager, memory);
+        return NULL;
+    }
+
+    size_t usable = mm_usable_size(manager, memory);
+    if (smallClassOf(manager, memory) != NULL)
+    {
+        if (bytes <= usable) return memory;
+    }
+    else if (isMapped(manager, memory) == true) return remapBlock(manager, (Node *)(memory - sizeof(Node)), bytes);
+    else if (blockNode(manager, memory) == (Node *)(memory - manager->headerSize)) // Interior buddy memory is moved
+    {
+        Node *node = (Node *)(memory - manager->headerSize);
+        Arena *arena = arenaOf(manager, node);
+
+        lockAcquire(&arena->lock);
+        bool_type resized = resizeNode(arena, node, bytes);
+        lockRelease(&arena->lock);
+
+        if (resized == true) return memory;
+    }
+
+    void *moved = mm_allocate(manager, bytes);
+    if (moved == NULL) return NULL;
+
+    memcpy(moved, memory, (usable < bytes) ? usable : bytes);
+    mm_deallocate(manager, memory);
+    return moved;
+}
+
+/**
+ * Destroys a heap created by mm_create, freeing everything used to manage it. Blocks still cached by any thread are
+ * dropped along with the heap and any memory it mapped is unmapped. Memory given to mm_create belongs to the caller,
+ * and no other thread may be using the heap while it is destroyed.
+ *
+ * @param manager - heap to be destroyed
+ */
+void mm_destroy(MemoryManager *manager)
+{
+    if (manager == NULL) return;
+
+    if (manager->sweepInterval != 0)
+    {
+        pthread_mutex_lock(&manager->sweepLock);
+        manager->sweeping = false;
+        pthread_cond_signal(&manager->sweepCond);
+        pthread_mutex_unlock(&manager->sweepLock);
+        pthread_join(manager->sweeper, NULL);
+    }
+    pthread_mutex_destroy(&manager->sweepLock);
+    pthread_cond_destroy(&manager->sweepCond);
+
+    if (manager->threadCaching == true)
+    {
+        pthread_key_delete(manager->cacheKey); // Stops the destructors of exiting threads touching the heap
+        while (manager->caches != NULL)
+        {
+            ThreadCache *cache = manager->caches;
+            manager->caches = cache->next;
+            free(cache);
+        }
+    }
+    if (manager->combining == true)
+    {
+        pthread_key_delete(manager->combineKey); // Stops the destructors of exiting threads touching the heap
+        while (manager->slots != NULL)
+        {
+            CombineSlot *slot = manager->slots;
+            manager->slots = slot->next;
+            free(slot);
+        }
+    }
+    pthread_key_delete(manager->arenaKey);
+    pthread_mutex_destroy(&manager->cacheLock);
+    pthread_mutex_destroy(&manager->mapLock);
+
+    for (size_t i = 0; i < manager->arenaCount; i++)
+    {
+        lockDestroy(&manager->arenas[i].lock);
+        for (size_t j = 0; manager->regionLocking == true && j <= REGION_LOCKS; j++)
+        {
+            lockDestroy(&manager->arenas[i].regionLocks[j]);
+        }
+    }
+    if (manager->regionLocking == true) free(manager->arenas[0].regionLocks); // Every arena's locks share one block
+    while (manager->mappedBlocks != NULL)
+    {
+        Node *node = manager->mappedBlocks;
+        manager->mappedBlocks = node->next;
+        munmap(node, node->size + sizeof(Node));
+    }
+    while (manager->segments != NULL)
+    {
+        Segment *segment = manager->segments;
+        manager->segments = segment->next;
+        munmap(segment, segment->size);
+    }
+    free(manager->smallClasses[SMALL_CLASSES - 1].bitmap); // The bitmaps of every class share one block
+    free(manager->arenas);
+    if (manager->mapping != NULL) munmap(manager->mapping, manager->mappingSize);
+    free(manager);
+}
+
+/**
+ * Initialises the heap used by allocate and deallocate, replacing any heap initialised before it. The heap is created
+ * with mm_create_ex, using the settings chosen by the memoryManager_ functions, and a null check is conducted to make
+ * sure that it has worked.
+ * Also, using the algorithm parameter, the function pointer for allocate is created based on which algorithm is
+ * passed - if an invalid one is chosen, first fit is chosen by default. If thread caches are enabled, allocate goes
+ * through them instead and the algorithm is used to refill them.
+ *
+ * @param memory - pointer to heap
+ * @param size - size of heap in bytes
+ * @param algorithm - the algorithm to be used
+ */
+void initialise(void *memory , size_t size, char *algorithm)
+{
+    mm_destroy(defaultManager);
+    defaultManager = mm_create_ex(memory, size, algorithm, &defaultOptions);
+
+    if (defaultManager == NULL)
+    {
+        fprintf(stderr, "Error: Unable to allocate memory in initialise().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    allocate = (defaultManager->threadCaching == true) ? &cachedAllocate : defaultManager->allocate;
+}
+
+/**
+ * Initialises the heap used by allocate and deallocate like initialise, but in memory the heap maps for itself using
+ * mm_create_mapped_ex, backed by huge pages where the system allows it.
+ *
+ * @param size - size of heap in bytes, rounded up to a whole number of huge pages
+ * @param algorithm - the algorithm to be used
+ */
+void initialise_mapped(size_t size, char *algorithm)
+{
+    mm_destroy(defaultManager);
+    defaultManager = mm_create_mapped_ex(size, algorithm, &defaultOptions);
+
+    if (defaultManager == NULL)
+    {
+        fprintf(stderr, "Error: Unable to map memory in initialise_mapped().\n");
+        exit(EXIT_FAILURE);
+    }
+
+    allocate = (defaultManager->threadCaching == true) ? &cachedAllocate : defaultManager->allocate;
+}
+
+/**
+ * Allocates memory from the heap set up by initialise whose address is a multiple of the alignment, such as a cache
+ * line or a page. The memory is deallocated with deallocate as normal.
+ *
+ * @param bytes - requested bytes to be allocated
+ * @param alignment - power of two the memory address must be a multiple of
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *allocate_aligned(size_t bytes, size_t alignment)
+{
+    return lockedAlignedFit(defaultManager, bytes, alignment);
+}
+
+/**
+ * Allocates a number of blocks from the heap set up by initialise while taking a lock only once.
+ *
+ * @param sizes - requested bytes of each block
+ * @param count - number of blocks
+ * @param memory - array the memory pointers are written to, with NULL for any that can't be allocated
+ * @return - number of blocks allocated
+ */
+size_t allocate_batch(size_t *sizes, size_t count, void **memory)
+{
+    return mm_allocate_batch(defaultManager, sizes, count, memory);
+}
+
+/**
+ * Allocates zeroed memory for an array from the heap set up by initialise.
+ *
+ * @param count - number of elements
+ * @param size - size of each element in bytes
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *callocate(size_t count, size_t size)
+{
+    return mm_callocate(defaultManager, count, size);
+}
+
+/**
+ * Resizes a block allocated from the heap set up by initialise, in place whenever it can be.
+ *
+ * @param memory - the memory pointer to be resized/NULL
+ * @param bytes - new size of the block in bytes
+ * @return - void memory pointer, which may have moved/NULL if it can't be resized, leaving the block as it was
+ */
+void *reallocate(void *memory, size_t bytes)
+{
+    return mm_reallocate(defaultManager, memory, bytes);
+}
+
+/**
+ * Finds how many bytes can be used in a block allocated from the heap set up by initialise.
+ *
+ * @param memory - the memory pointer to be looked up
+ * @return - usable bytes of the block/0 if memory is NULL
+ */
+size_t usable_size(void *memory)
+{
+    return mm_usable_size(defaultManager, memory);
+}
+
+/**
+ * Deallocate memory from the heap set up by initialise.
+ *
+ * @param memory - the memory pointer to be unallocated
+ */
+void deallocate(void *memory)
+{
+    mm_deallocate(defaultManager, memory);
+}
+
+/**
+ * Deallocates a number of blocks from the heap set up by initialise while taking each lock only once.
+ *
+ * @param memory - the memory pointers to be unallocated, which are left as they are/NULL entries are skipped
+ * @param count - number of pointers
+ */
+void deallocate_batch(void **memory, size_t count)
+{
+    mm_deallocate_batch(defaultManager, memory, count);
+}
+
+/**
+ * Takes a new slab from the heap of a pool and pushes every object in it onto the pool's free stack.
+ *
+ * @param pool - pool to be grown
+ * @return - true if a slab was added/false if the heap is full
+ */
+static bool_type poolGrow(Pool *pool)
+{
+    size_t count = (POOL_SLAB_SIZE - sizeof(void *)) / pool->objectSize;
+    if (count < 1) count = 1;
+
+    void *slab = mm_allocate(pool->manager, sizeof(void *) + count * pool->objectSize);
+    if (slab == NULL) return false;
+
+    /* Remember the slab so that it can be handed back when the pool is destroyed */
+    void *slabs = __atomic_load_n(&pool->slabs, __ATOMIC_RELAXED);
+    do
+    {
+        *(void **)(slab) = slabs;
+    }while(!__atomic_compare_exchange_n(&pool->slabs, &slabs, slab, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    void *first = slab + sizeof(void *);
+    for (size_t i = 0; i + 1 < count; i++) *(void **)(first + i * pool->objectSize) = first + (i + 1) * pool->objectSize;
+
+    stackPush(&pool->head, first, first + (count - 1) * pool->objectSize, 0);
+    return true;
+}
+
+/**
+ * Creates a pool of objects of a fixed size in a heap created by mm_create. Objects are handed out and taken back by
+ * pool_alloc and pool_free with a single compare and swap, only calling mm_allocate to take a new slab when every
+ * object is in use. The pool must be destroyed before the heap is.
+ *
+ * @param manager - heap the slabs are taken from
+ * @param objectSize - size in bytes of every object
+ * @return - the new pool/NULL if it can't be created
+ */
+Pool *mm_pool_create(MemoryManager *manager, size_t objectSize)
+{
+    if (manager == NULL || objectSize < 1 || objectSize > POOL_SLAB_SIZE) return NULL;
+
+    Pool *pool = calloc(1, sizeof(Pool));
+    if (pool == NULL) return NULL;
+
+    /* Free objects hold the link to the next one, and every object stays aligned for a pointer */
+    if (objectSize < sizeof(void *)) objectSize = sizeof(void *);
+    pool->objectSize = (objectSize + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    pool->manager = manager;
+
+    return pool;
+}
+
+/**
+ * Creates a pool of objects of a fixed size like mm_pool_create, taking its slabs from the heap set up by initialise,
+ * so the pool must be destroyed before that heap is replaced.
+ *
+ * @param objectSize - size in bytes of every object
+ * @return - the new pool/NULL if it can't be created
+ */
+Pool *pool_create(size_t objectSize)
+{
+    return mm_pool_create(defaultManager, objectSize);
+}
+
+/**
+ * Allocates an object from a pool by popping the head of its free stack, growing the pool by a slab if it is empty.
+ * Objects are never returned to the heap while the pool exists, so the link read from the head is always readable
+ * even if another thread pops it first, in which case the tag makes the compare and swap fail.
+ *
+ * @param pool - pool to allocate from
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *pool_alloc(Pool *pool)
+{
+    if (pool == NULL) return NULL;
+
+    while (true)
+    {
+        void *object = stackPop(&pool->head, 0);
+
+        if (object != NULL) return object;
+        if (poolGrow(pool) == false) return NULL;
+    }
+}
+
+/**
+ * Frees an object back to the pool it was allocated from by pushing it onto the pool's free stack.
+ *
+ * @param pool - pool the object was allocated from
+ * @param object - the object to be freed
+ */
+void pool_free(Pool *pool, void *object)
+{
+    if (pool == NULL || object == NULL) return;
+    stackPush(&pool->head, object, object, 0);
+}
+
+/**
+ * Destroys a pool, handing every slab back to its heap. Any objects still in use are freed along with
+ * it, and no other thread may be using the pool while it is destroyed.
+ *
+ * @param pool - pool to be destroyed
+ */
+void pool_destroy(Pool *pool)
+{
+    if (pool == NULL) return;
+
+    while (pool->slabs != NULL)
+    {
+        void *slab = pool->slabs;
+        pool->slabs = *(void **)(slab);
+        mm_deallocate(pool->manager, slab);
+    }
+    free(pool);
+}
+
+/**
+ * Gives the whole pages inside every free node of the heap set up by initialise back to the operating system, as
+ * mm_trim does, which only trims a heap set up by initialise_mapped or the segments it grew into.
+ *
+ * @return - bytes given back
+ */
+size_t memoryManager_trim()
+{
+    return mm_trim(defaultManager);
+}
+
+/**
+ * Finds the size of the biggest free node, which is how much can be allocated at once. Worst fit and best fit answer
+ * this straight from the heap and tree of each arena, while the other algorithms loop over the lists.
+ *
+ * @return - size in bytes of the biggest free node/0 if there are none
+ */
+size_t memoryManager_largestFree()
+{
+    size_t largest = 0;
+
+    for (size_t i = 0; defaultManager != NULL && i < defaultManager->arenaCount; i++)
+    {
+        Arena *arena = &defaultManager->arenas[i];
+
+        lockAcquire(&arena->lock);
+        if (defaultManager->fit == &worstFitNode)
+        {
+            if (arena->heapRoot != NULL && arena->heapRoot->size > largest) largest = arena->heapRoot->size;
+        }
+        else if (defaultManager->fit == &bestFitNode)
+        {
+            Node *node = arena->treeRoot;
+            while (node != NULL && TREE_LINKS(node)->child[1] != NULL) node = TREE_LINKS(node)->child[1];
+            if (node != NULL && node->size > largest) largest = node->size;
+        }
+        else if (defaultManager->fit == &compactFitNode)
+        {
+            for (void *block = arena->firstBlock; COMPACT_SIZE(block) != 0; block += COMPACT_SIZE(block))
+            {
+                size_t size = COMPACT_SIZE(block) - sizeof(size_t);
+                if ((COMPACT_HEADER(block) & COMPACT_FREE) && size > largest) largest = size;
+            }
+        }
+        else
+        {
+            Node *node = arena->firstBlock;
+            do
+            {
+                if (node->free == true && node->size > largest) largest = node->size;
+                node = node->next;
+            }while(node != arena->firstBlock);
+        }
+        lockRelease(&arena->lock);
+    }
+
+    return largest;
+}
+
+/**
+ * Prints out the blocks of a compact arena in the same format as nodes, walking from header to header as compact
+ * blocks have no next pointer.
+ *
+ * @param arena - arena to be printed
+ */
+static void compactPrintf(Arena *arena)
+{
+    int blkCounter = 1; // Block counter
+    for (void *block = arena->firstBlock; COMPACT_SIZE(block) != 0; block += COMPACT_SIZE(block))
+    {
+        size_t size = COMPACT_SIZE(block);
+
+        // If at end don't print comma
+        printf("Block : %d ",blkCounter++);
+        printf(COMPACT_SIZE(block + size) == 0 ? "(Free : %d, Size : %zu, Node Size : %zu, Memory : %p)\n":"(Free : %d, Size : %zu, Node Size : %zu, Memory : %p),\n",
+               (int)(COMPACT_HEADER(block) & COMPACT_FREE), size - sizeof(size_t), sizeof(size_t), block + sizeof(size_t));
+    }
+}
+
+/**
+ *  Prints out all node details in a readable format, arena by arena when there is more than one, followed by how full
+ *  the small block tier is if the heap has one
+ */
+void memoryManager_printf()
+{
+    for (size_t i = 0; defaultManager != NULL && i < defaultManager->arenaCount; i++)
+    {
+        Arena *arena = &defaultManager->arenas[i];
+
+        printf("\n");
+        if (defaultManager->arenaCount > 1) printf("Arena : %zu\n", i);
+
+        if (defaultManager->fit == &compactFitNode)
+        {
+            compactPrintf(arena);
+            continue;
+        }
+
+        int blkCounter = 1; // Block counter
+        for (Node *node = arena->firstBlock; node != NULL; node = node->next)
+        {
+            // If at end don't print comma
+            printf("Block : %d ",blkCounter++);
+            printf(node->next == arena->firstBlock ? "(Free : %d, Size : %d, Node Size : %d, Memory : %p)\n":"(Free : %d, Size : %d, Node Size : %d, Memory : %p),\n",
+                   node->free, node->size, sizeof(Node), ((void *)(node) + sizeof(Node)));
+            if(node->next == arena->firstBlock) break;
+        }
+    }
+
+    /* The small block tier has no nodes, so only how full each class is can be shown */
+    for (size_t class = 0; defaultManager != NULL && defaultManager->smallBlocks == true && class < SMALL_CLASSES; class++)
+    {
+        SmallClass *small = &defaultManager->smallClasses[class];
+        size_t used = 0;
+
+        for (size_t word = 0; word < small->words; word++) used += __builtin_popcountll(small->bitmap[word]);
+        if (class == 0) printf("\n");
+        printf("Small Blocks : (Chunk Size : %zu, Used : %zu, Chunks : %zu)\n", small->chunkSize, used, small->words * 64);
     }
     printf("\n");
 }
@@ -30,14 +30,48 @@ typedef enum
 typedef struct _Node
 {
     bool_type free;
+    unsigned int flags; // NODE_ flags, which fit in the padding after free
     size_t size;
     struct _Node *next;
     struct _Node *prev;
 }Node;
 
+/**
+ * Handle to a heap created by mm_create, which is managed independently of every other heap.
+ */
+typedef struct _MemoryManager MemoryManager;
+
+/**
+ * Settings of a heap passed to mm_create_ex and mm_create_mapped_ex. A zeroed struct, like passing NULL, gives a heap
+ * with one mutex guarded arena and every other feature turned off. The memoryManager_ functions set the options of the
+ * heap set up by initialise.
+ */
+typedef struct _MemoryOptions
+{
+    size_t arenas; // Number of arenas the heap is split into, each with its own lock, 0 is treated as 1
+    char *lockPolicy; // "Mutex", "None", "Spin", "Ticket" or "Futex", a mutex if NULL or anything else
+    bool_type threadCache; // Whether small blocks go through per-thread caches
+    bool_type smallBlocks; // Whether small requests are served by the small block tier
+    bool_type zeroedMemory; // Whether the memory given to the heap is all zero
+    bool_type growable; // Whether segments are mapped when the heap is full
+    size_t trimThreshold; // Size of free node from which pages the heap mapped are given back to the system, 0 never
+    size_t mapThreshold; // Size of request from which blocks are given a mapping of their own, 0 never
+    bool_type deferredCoalescing; // Whether deallocated blocks are left pending until they are needed
+    unsigned int sweepInterval; // Milliseconds between sweeps of pending blocks, 0 for no sweeper
+    bool_type flatCombining; // Whether waiting threads have their requests carried out by the lock holder
+    bool_type lockFreeClasses; // Whether small blocks are served from lock-free stacks of size classes
+    bool_type remoteFrees; // Whether frees from other threads' arenas are queued
+    bool_type regionLocking; // Whether first and next fit lock only the regions of the list they work on
+}MemoryOptions;
+
+/**
+ * Handle to a pool of fixed size objects created by mm_pool_create or pool_create.
+ */
+typedef struct _Pool Pool;
+
 /* Function names */
 
-void* (*allocate)(size_t); // Function pointer to one of the algorithm functions
+extern void* (*allocate)(size_t); // Function pointer to one of the algorithm functions
 
 Node *freeNode(Node *node, size_t bytes);
 
@@ -49,10 +83,108 @@ void *bestFit(size_t bytes);
 
 void *worstFit(size_t bytes);
 
+void *segregatedFit(size_t bytes);
+
+void *tlsfFit(size_t bytes);
+
+void *buddyFit(size_t bytes);
+
+void *compactFit(size_t bytes);
+
+void *cachedAllocate(size_t bytes);
+
+void memoryManager_threadCache(bool_type enabled);
+
+void memoryManager_arenas(size_t count);
+
+void memoryManager_smallBlocks(bool_type enabled);
+
+void memoryManager_zeroedMemory(bool_type zeroed);
+
+void memoryManager_growable(bool_type enabled);
+
+void memoryManager_trimThreshold(size_t bytes);
+
+void memoryManager_mapThreshold(size_t bytes);
+
+void memoryManager_deferredCoalescing(bool_type enabled);
+
+void memoryManager_sweeper(unsigned int milliseconds);
+
+void memoryManager_lockPolicy(char *policy);
+
+void memoryManager_flatCombining(bool_type enabled);
+
+void memoryManager_lockFreeClasses(bool_type enabled);
+
+void memoryManager_remoteFrees(bool_type enabled);
+
+void memoryManager_regionLocking(bool_type enabled);
+
+MemoryManager *mm_create(void *memory, size_t size, char *algorithm);
+
+MemoryManager *mm_create_mapped(size_t size, char *algorithm);
+
+MemoryManager *mm_create_ex(void *memory, size_t size, char *algorithm, const MemoryOptions *options);
+
+MemoryManager *mm_create_mapped_ex(size_t size, char *algorithm, const MemoryOptions *options);
+
+void *mm_allocate(MemoryManager *manager, size_t bytes);
+
+void *mm_allocate_aligned(MemoryManager *manager, size_t bytes, size_t alignment);
+
+size_t mm_allocate_batch(MemoryManager *manager, size_t *sizes, size_t count, void **memory);
+
+void *mm_callocate(MemoryManager *manager, size_t count, size_t size);
+
+void *mm_reallocate(MemoryManager *manager, void *memory, size_t bytes);
+
+size_t mm_usable_size(MemoryManager *manager, void *memory);
+
+void mm_deallocate(MemoryManager *manager, void *memory);
+
+void mm_deallocate_batch(MemoryManager *manager, void **memory, size_t count);
+
+size_t mm_trim(MemoryManager *manager);
+
+size_t mm_combined(MemoryManager *manager);
+
+size_t mm_region_served(MemoryManager *manager);
+
+Pool *mm_pool_create(MemoryManager *manager, size_t objectSize);
+
+void mm_destroy(MemoryManager *manager);
+
 void initialise(void *memory , size_t size, char *algorithm);
 
+void initialise_mapped(size_t size, char *algorithm);
+
+void *allocate_aligned(size_t bytes, size_t alignment);
+
+size_t allocate_batch(size_t *sizes, size_t count, void **memory);
+
+void *callocate(size_t count, size_t size);
+
+void *reallocate(void *memory, size_t bytes);
+
+size_t usable_size(void *memory);
+
 void deallocate(void *memory);
 
+void deallocate_batch(void **memory, size_t count);
+
+Pool *pool_create(size_t objectSize);
+
+void *pool_alloc(Pool *pool);
+
+void pool_free(Pool *pool, void *object);
+
+void pool_destroy(Pool *pool);
+
+size_t memoryManager_trim();
+
+size_t memoryManager_largestFree();
+
 void memoryManager_printf();
 
 #endif //COURSEWORK_2_PART3_H
@@ -0,0 +1,116 @@
+/**
+ *
+ *  Authors :           James Grant & Callum Anderson
+ *  Last Modified :     8/12/19
+ *  Version :           1.4
+ *  Description :       Part 3 benchmark that compares the lock policies a heap can be created with, alone, with flat
+ *                      combining, with lock-free size classes and with region locking, by timing threads that allocate
+ *                      and deallocate from a single arena at once.
+ *
+ */
+
+#include "part3.h"
+#include <time.h>
+
+#define BENCH_THREADS 8 // Most threads run at once, every power of two up to it is timed
+#define BENCH_OPERATIONS 100000 // Allocations, each followed by a deallocation, made by every thread
+#define BENCH_HEAP_SIZE (1 << 20)
+
+#define BENCH_PLAIN 0 // Heap with only the lock policy
+#define BENCH_COMBINING 1 // Heap with flat combining
+#define BENCH_CLASSES 2 // Heap with lock-free size classes
+#define BENCH_REGIONS 3 // Next fit heap with region locking, whose regions are guarded by the lock policy
+#define BENCH_MODES 4
+
+pthread_t threads[BENCH_THREADS];
+
+/**
+ * Thread body for the benchmark that keeps a few blocks of varying sizes alive, replacing one with each allocation,
+ * so that the critical sections are as short as the heap allows.
+ *
+ * @param argument - heap to be used
+ * @return - NULL
+ */
+void *benchWorker(void *argument)
+{
+    MemoryManager *manager = (MemoryManager *)(argument);
+    void *blocks[8] = {NULL};
+
+    for (int i = 0; i < BENCH_OPERATIONS; i++)
+    {
+        int slot = i % 8;
+
+        mm_deallocate(manager, blocks[slot]);
+        blocks[slot] = mm_allocate(manager, 16 + (i * 37) % 240);
+    }
+    for (int slot = 0; slot < 8; slot++) mm_deallocate(manager, blocks[slot]);
+    return NULL;
+}
+
+/**
+ * Function that times a number of threads working on one heap guarded by the given lock.
+ *
+ * @param policy - lock to be used by the heap
+ * @param mode - one of the BENCH_ modes the heap is created with
+ * @param threadCount - number of threads to be run at once
+ * @return - operations per microsecond across every thread
+ */
+double benchPolicy(char *policy, int mode, int threadCount)
+{
+    void *heap = malloc(BENCH_HEAP_SIZE);
+    struct timespec start, end;
+
+    MemoryOptions options = {.lockPolicy = policy};
+    options.flatCombining = (mode == BENCH_COMBINING) ? true : false;
+    options.lockFreeClasses = (mode == BENCH_CLASSES) ? true : false;
+    options.regionLocking = (mode == BENCH_REGIONS) ? true : false;
+    char *algorithm = (mode == BENCH_REGIONS) ? "NextFit" : "TLSF";
+    MemoryManager *manager = mm_create_ex(heap, BENCH_HEAP_SIZE, algorithm, &options);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < threadCount; i++) pthread_create(&(threads[i]), NULL, &benchWorker, manager);
+    for (int i = 0; i < threadCount; i++) pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    mm_destroy(manager);
+    free(heap);
+
+    double microseconds = (double)(end.tv_sec - start.tv_sec) * 1e6 + (double)(end.tv_nsec - start.tv_nsec) / 1e3;
+    return 2.0 * BENCH_OPERATIONS * threadCount / microseconds;
+}
+
+/**
+ * Main function that prints a table of the throughput of each lock policy at each number of threads for each mode,
+ * leaving out no lock at all past one thread as it isn't safe there, and leaving it out of the modes built for threads.
+ *
+ * @return - exit status
+ */
+int main()
+{
+    char *policies[5] = {"None", "Mutex", "Spin", "Ticket", "Futex"};
+    char *modes[BENCH_MODES] = {"Lock Policy", "Flat Combining", "Lock-Free Size Class", "Region Locking (NextFit)"};
+
+    for (int mode = 0; mode < BENCH_MODES; mode++)
+    {
+        int firstPolicy = (mode == BENCH_PLAIN) ? 0 : 1;
+
+        if (mode > 0) printf("\n");
+        printf("---------- %s Benchmark (operations per microsecond) ----------\n", modes[mode]);
+        printf("%-8s", "Threads");
+        for (int i = firstPolicy; i < 5; i++) printf("%10s", policies[i]);
+        printf("\n");
+
+        for (int threadCount = 1; threadCount <= BENCH_THREADS; threadCount *= 2)
+        {
+            printf("%-8d", threadCount);
+            for (int i = firstPolicy; i < 5; i++)
+            {
+                if (threadCount > 1 && i == 0) printf("%10s", "-");
+                else printf("%10.2f", benchPolicy(policies[i], mode, threadCount));
+            }
+            printf("\n");
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
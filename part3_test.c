@@ -9,6 +9,7 @@
  */
 
 #include "part3.h"
+#include <unistd.h>
 
 pthread_t threads[20];
 
@@ -18,9 +19,10 @@ pthread_t threads[20];
  *
  * @param node - node pointer to first node
  * @param startAddress - address of first memory block
+ * @param size - size of the heap
  * @return - true/false
  */
-bool_type listTest(Node* node, void *startAddress)
+bool_type listTest(Node* node, void *startAddress, size_t size)
 {
     void *currentAddress = startAddress;
     size_t totalSize = 0;
@@ -33,10 +35,33 @@ bool_type listTest(Node* node, void *startAddress)
         totalSize += node->size + sizeof(Node); // Increments size
         node = node->next;
     }while(node != firstNode);
-    if (totalSize != 200) return false; // Checks size of list integrity
+    if (totalSize != size) return false; // Checks size of list integrity
     return true;
 }
 
+/**
+ * Thread body that allocates from the heap set up by initialise.
+ *
+ * @param argument - requested bytes to be allocated
+ * @return - void memory pointer/NULL if can't be allocated
+ */
+void *allocateWorker(void *argument)
+{
+    return allocate((size_t)(argument));
+}
+
+/**
+ * Thread body that deallocates from the heap set up by initialise.
+ *
+ * @param argument - the memory pointer to be unallocated
+ * @return - NULL
+ */
+void *deallocateWorker(void *argument)
+{
+    deallocate(argument);
+    return NULL;
+}
+
 /**
  * Function that can be used to test the functionality of all the algorithms using threads.
  *
@@ -63,14 +88,14 @@ void threadTest(char *algorithm)
 
     for (int i = 0; i < 20; i++)
     {
-        error = pthread_create(&(threads[i]), NULL, (void *(*)(void *)) allocate, (void *) 10 + i);
+        error = pthread_create(&(threads[i]), NULL, &allocateWorker, (void *)(size_t)(10 + i));
 
         /* Check that thread has been successfully created, otherwise throw error */
         if (error != 0) fprintf(stderr, "Error: Unable to create thread in baseTest().\n");
     }
 
     printf("Allocating test : ");
-    if (listTest(node, startAddress) == true) printf("Passed!\n");
+    if (listTest(node, startAddress, size) == true) printf("Passed!\n");
     else printf("Failed!\n");
 
     memoryManager_printf();
@@ -83,14 +108,16 @@ void threadTest(char *algorithm)
         pthread_join(threads[i], &returnValue); // Get the return values for each thread and print them
         printf(i == 19 ? "(Thread %d: %p)\n" : "(Thread %d: %p), ", threads[i], returnValue);
 
-        error = pthread_create(&(threads[i]), NULL, (void *(*)(void *)) deallocate, returnValue); // Deallocate the blocks
+        error = pthread_create(&(threads[i]), NULL, &deallocateWorker, returnValue); // Deallocate the blocks
 
         /* Check that thread has been successfully created, otherwise throw error */
         if (error != 0) fprintf(stderr, "Error: Unable to create thread in baseTest().\n");
     }
 
+    for (int i = 0; i < 20; i++) pthread_join(threads[i], NULL); // Wait for every block to be deallocated
+
     printf("Deallocating test : ");
-    if (node->free == true && node->size == 184) printf("Passed!\n");
+    if (node->free == true && node->size == size - sizeof(Node)) printf("Passed!\n");
     else printf("Failed!\n");
 
     memoryManager_printf();
@@ -98,10 +125,10 @@ void threadTest(char *algorithm)
     printf("---------- Lock Test ----------\n");
     printf("Try and fully allocate the memory to test that all locks have been unlocked.\n");
 
-    void *test = allocate(184);
+    void *test = allocate(size - sizeof(Node));
     printf("Lock Test : ");
     node = ((Node *)(test - sizeof(Node)));
-    if (node->free == false && node->size == 184) printf("Passed!\n");
+    if (test != NULL && node->free == false && node->size == size - sizeof(Node)) printf("Passed!\n");
     else printf("Failed!\n");
 
     memoryManager_printf();
@@ -109,30 +136,1679 @@ void threadTest(char *algorithm)
 }
 
 /**
- * Function that tests each algorithm individually.
+ * Thread body for the thread cache test that repeatedly allocates and deallocates small blocks, writing to each one
+ * so that overlapping blocks would be noticed.
+ *
+ * @param argument - unused
+ * @return - NULL if every block held its contents/non NULL otherwise
  */
-void testHarness()
+void *cacheWorker(void *argument)
 {
-    printf("---------- Testing Begins ----------\n");
+    void *blocks[16] = {NULL};
+    void *result = NULL;
 
-    printf(" -- As all the algorithms are based off of part 2, the only test necessary for them is that their "
-           "algorithm operates correctly with threads -- \n ");
+    for (int i = 0; i < 2000; i++)
+    {
+        int slot = i % 16;
+        size_t bytes = 1 + (i * 37) % 256;
 
-    printf("\n---------- Begin First Fit Test ----------\n");
-    threadTest("FirstFit");
-    printf("\n---------- End First Fit Test ----------\n");
+        if (blocks[slot] != NULL)
+        {
+            if (*(unsigned char *)(blocks[slot]) != (unsigned char)(slot)) result = argument;
+            deallocate(blocks[slot]);
+        }
+        blocks[slot] = allocate(bytes);
+        if (blocks[slot] != NULL) memset(blocks[slot], slot, bytes);
+    }
+    for (int slot = 0; slot < 16; slot++) deallocate(blocks[slot]);
+    return result;
+}
 
-    printf("\n---------- Begin Best Fit Test ----------\n");
-    threadTest("BestFit");
-    printf("\n---------- End Best Fit Test ----------\n");
+/**
+ * Function that tests that the thread caches serve allocations from many threads and that every cached block is
+ * handed back to the shared list when its thread exits.
+ *
+ * @param algorithm - algorithm to be used to refill the caches
+ */
+void threadCacheTest(char *algorithm)
+{
+    void *returnValue;
+    bool_type contentsKept = true;
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
 
-    printf("\n---------- Begin Worst Fit Test ----------\n");
-    threadTest("WorstFit");
-    printf("\n---------- End Worst Fit Test ----------\n");
+    memoryManager_threadCache(true);
+    initialise(heap, size, algorithm);
 
-    printf("\n---------- Begin Next Fit Test ----------\n");
-    threadTest("NextFit");
-    printf("\n---------- End Next Fit Test ----------\n");
+    for (int i = 0; i < 8; i++) pthread_create(&(threads[i]), NULL, &cacheWorker, heap);
+    for (int i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) contentsKept = false;
+    }
+
+    printf("Thread cache contents test : ");
+    if (contentsKept == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Thread cache drain test : ");
+    Node *node = (Node *)(heap);
+    if (node->free == true && node->size == size - sizeof(Node) && node->next == node) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    memoryManager_threadCache(false);
+    free(heap);
+}
+
+/**
+ * Function that tests that best fit still picks the smallest hole that fits when its free nodes are kept in a tree,
+ * with holes of several sizes freed in no particular order.
+ */
+void bestFitTreeTest()
+{
+    size_t size = 4096;
+    size_t holeSizes[6] = {200, 48, 120, 80, 304, 80};
+    void *holes[6];
+    void *spacers[6];
+    void *heap = malloc(size);
+
+    initialise(heap, size, "BestFit");
+
+    /* Separate the holes with allocated spacers so that they can't coalesce */
+    for (int i = 0; i < 6; i++)
+    {
+        holes[i] = allocate(holeSizes[i]);
+        spacers[i] = allocate(8);
+    }
+    for (int i = 5; i >= 0; i--) deallocate(holes[i]);
+
+    memoryManager_printf();
+
+    printf("Best fit tree smallest hole test : ");
+    void *test1 = allocate(70); // The two 80 byte holes fit, the lower addressed one is used
+    void *test2 = allocate(100);
+    if (test1 == holes[3] && test2 == holes[2]) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Best fit tree coalescing test : ");
+    deallocate(test1);
+    deallocate(test2);
+    for (int i = 0; i < 6; i++) deallocate(spacers[i]);
+
+    Node *node = (Node *)(heap);
+    if (node->free == true && node->size == size - sizeof(Node) && allocate(size - sizeof(Node)) != NULL)
+        printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that tests that worst fit uses the biggest hole when its free nodes are kept in a heap, and that the
+ * biggest free node can be asked for while doing so.
+ */
+void worstFitHeapTest()
+{
+    size_t size = 4096;
+    size_t holeSizes[5] = {200, 48, 600, 80, 304};
+    void *holes[5];
+    void *spacers[5];
+    void *heap = malloc(size);
+
+    initialise(heap, size, "WorstFit");
+
+    /* Separate the holes with allocated spacers so that they can't coalesce, then fill the rest of the heap */
+    for (int i = 0; i < 5; i++)
+    {
+        holes[i] = allocate(holeSizes[i]);
+        spacers[i] = allocate(8);
+    }
+    void *rest = allocate(memoryManager_largestFree());
+    for (int i = 0; i < 5; i++) deallocate(holes[i]);
+
+    memoryManager_printf();
+
+    printf("Worst fit heap largest free test : ");
+    if (memoryManager_largestFree() == 600) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Worst fit heap biggest hole test : ");
+    void *test1 = allocate(40); // Goes in the 600 byte hole even though smaller ones fit
+    void *test2 = allocate(40); // What is left of the 600 byte hole is still the biggest
+    if (test1 == holes[2] && test2 > test1 && test2 < holes[3] &&
+        memoryManager_largestFree() == 600 - 2 * (40 + sizeof(Node))) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Worst fit heap coalescing test : ");
+    deallocate(test1);
+    deallocate(test2);
+    deallocate(rest);
+    for (int i = 0; i < 5; i++) deallocate(spacers[i]);
+    if (memoryManager_largestFree() == size - sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that tests the lists of TLSF. A request is rounded up to the next second level list so that any node in the
+ * list found fits, which passes over a hole in the request's own list that would fit, falling back to that list only
+ * when nothing bigger is free. Lists that empty must be dropped from the bitmaps, and lists that fill added back, with
+ * the first level bitmap letting a request find a node at the next power of two.
+ */
+void tlsfListTest()
+{
+    size_t size = 4096;
+    void *heap = malloc(size);
+
+    initialise(heap, size, "TLSF");
+
+    /* Holes of 264 and 296 bytes fall in the first and third of the 16 byte wide lists between 256 and 512 bytes */
+    void *small = allocate(264);
+    void *spacer1 = allocate(8);
+    void *large = allocate(296);
+    void *spacer2 = allocate(8);
+    void *rest = allocate(memoryManager_largestFree());
+    deallocate(small);
+    deallocate(large);
+
+    memoryManager_printf();
+
+    printf("TLSF good fit rounding test : ");
+    void *test1 = allocate(260); // Rounded up past the 264 byte hole's list, so the 296 byte hole is used
+    if (test1 == large) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("TLSF own list fallback test : ");
+    void *test2 = allocate(264); // Nothing is left above its own list, whose first node is big enough
+    if (test2 == small) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("TLSF bitmap test : ");
+    void *test3 = allocate(16); // Every list is empty, so no bit may be left set
+    deallocate(test2);
+    void *test4 = allocate(250); // Only found through the first level bit of the list 264 bytes went back into
+    if (test3 == NULL && test4 == small) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("TLSF coalescing test : ");
+    deallocate(test1);
+    deallocate(test4);
+    deallocate(spacer1);
+    deallocate(spacer2);
+    deallocate(rest);
+    if (memoryManager_largestFree() == size - sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that tests that the buddy algorithm is thread safe, using a heap that is a power of two so that it is a
+ * single buddy block to begin with.
+ */
+void buddyThreadTest()
+{
+    size_t size = 1024;
+    void *heap = malloc(size);
+    void *returnValue;
+    void *blocks[20];
+
+    initialise(heap, size, "Buddy");
+
+    for (int i = 0; i < 20; i++) pthread_create(&(threads[i]), NULL, &allocateWorker, (void *)(size_t)(10 + i));
+    for (int i = 0; i < 20; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        blocks[i] = returnValue;
+    }
+    memoryManager_printf();
+
+    /* Every allocated block must be a power of two aligned to its size within the heap */
+    printf("Buddy allocating test : ");
+    bool_type aligned = true;
+    for (int i = 0; i < 20; i++)
+    {
+        if (blocks[i] == NULL) continue;
+
+        Node *node = (Node *)(blocks[i] - sizeof(Node));
+        size_t blockSize = node->size + sizeof(Node);
+        if ((blockSize & (blockSize - 1)) != 0 || ((void *)(node) - heap) % blockSize != 0) aligned = false;
+    }
+    if (aligned == true && listTest((Node *)(heap), heap + sizeof(Node), size) == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    for (int i = 0; i < 20; i++) pthread_create(&(threads[i]), NULL, &deallocateWorker, blocks[i]);
+    for (int i = 0; i < 20; i++) pthread_join(threads[i], NULL);
+
+    printf("Buddy deallocating test : ");
+    Node *node = (Node *)(heap);
+    if (node->free == true && node->size == size - sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that tests a heap split into arenas, checking that threads allocating at the same time keep their blocks
+ * apart, that a request spills into another arena once the thread's own is full, and that every arena coalesces back
+ * into a single node.
+ *
+ * @param algorithm - algorithm to be used in every arena
+ */
+void arenaTest(char *algorithm)
+{
+    void *returnValue;
+    void *blocks[4];
+    bool_type contentsKept = true;
+    bool_type spilled = true;
+    bool_type coalesced = true;
+    size_t size = 1 << 16;
+    size_t span = size / 4;
+    void *heap = malloc(size);
+
+    memoryManager_arenas(4);
+    initialise(heap, size, algorithm);
+
+    for (int i = 0; i < 8; i++) pthread_create(&(threads[i]), NULL, &cacheWorker, heap);
+    for (int i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) contentsKept = false;
+    }
+
+    printf("Arena contents test : ");
+    if (contentsKept == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* Each block nearly fills an arena, so all four can only be allocated if the later ones use the other arenas */
+    for (int i = 0; i < 4; i++)
+    {
+        blocks[i] = allocate(span - 2 * sizeof(Node));
+        if (blocks[i] == NULL) spilled = false;
+    }
+
+    printf("Arena spill test : ");
+    if (spilled == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    for (int i = 0; i < 4; i++) deallocate(blocks[i]);
+
+    if (!strcmp(algorithm, "Buddy"))
+    {
+        /* Buddy blocks never span two arenas, so on the empty heap the largest request is an arena less its node */
+        printf("Arena ceiling test : ");
+        void *largest = allocate(span - sizeof(Node));
+        if (largest != NULL && allocate(span) == NULL && allocate(size / 2) == NULL) printf("Passed!\n");
+        else printf("Failed!\n");
+        deallocate(largest);
+    }
+    else
+    {
+        /* Requests no arena can hold run on over the arenas after the first, the rest of the last one staying usable */
+        printf("Arena span test : ");
+        char *spanning = allocate(size / 2);
+        if (spanning != NULL) memset(spanning, 1, size / 2);
+        void *rest = allocate(span / 2);
+        void *whole = allocate(size - sizeof(Node)); // Needs every arena to be free
+        if (spanning != NULL && rest != NULL && whole == NULL && spanning[size / 2 - 1] == 1) printf("Passed!\n");
+        else printf("Failed!\n");
+        deallocate(spanning);
+        deallocate(rest);
+
+        printf("Arena whole heap test : ");
+        whole = allocate(size - sizeof(Node));
+        if (whole != NULL) printf("Passed!\n");
+        else printf("Failed!\n");
+        deallocate(whole);
+    }
+
+    printf("Arena coalescing test : ");
+    for (int i = 0; i < 4; i++)
+    {
+        Node *node = (Node *)(heap + i * span);
+        if (node->free == false || node->size != span - sizeof(Node) || node->next != node) coalesced = false;
+    }
+    if (coalesced == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    memoryManager_arenas(1);
+    free(heap);
+}
+
+/**
+ * Thread body for the heap handle test that allocates and deallocates blocks in its own heap, writing to each one so
+ * that overlapping blocks would be noticed.
+ *
+ * @param argument - heap to be used
+ * @return - NULL if every block held its contents/non NULL otherwise
+ */
+void *heapWorker(void *argument)
+{
+    MemoryManager *manager = (MemoryManager *)(argument);
+    void *blocks[16] = {NULL};
+    void *result = NULL;
+
+    for (int i = 0; i < 2000; i++)
+    {
+        int slot = i % 16;
+        size_t bytes = 1 + (i * 53) % 200;
+
+        if (blocks[slot] != NULL)
+        {
+            if (*(unsigned char *)(blocks[slot]) != (unsigned char)(slot)) result = argument;
+            mm_deallocate(manager, blocks[slot]);
+        }
+        blocks[slot] = mm_allocate(manager, bytes);
+        if (blocks[slot] != NULL) memset(blocks[slot], slot, bytes);
+    }
+    for (int slot = 0; slot < 16; slot++) mm_deallocate(manager, blocks[slot]);
+    return result;
+}
+
+/**
+ * Function that tests that heaps created with mm_create are independent, running a different algorithm in each heap
+ * at the same time and checking that each one is left as a single free node, and that the options given to
+ * mm_create_ex only apply to the heap they are passed to.
+ */
+void heapHandleTest()
+{
+    char *algorithms[4] = {"FirstFit", "BestFit", "TLSF", "Buddy"};
+    MemoryManager *managers[4];
+    void *heaps[4];
+    void *returnValue;
+    bool_type contentsKept = true;
+    bool_type coalesced = true;
+    size_t size = 1 << 14;
+
+    for (int i = 0; i < 4; i++)
+    {
+        heaps[i] = malloc(size);
+        managers[i] = mm_create(heaps[i], size, algorithms[i]);
+    }
+
+    for (int i = 0; i < 8; i++) pthread_create(&(threads[i]), NULL, &heapWorker, managers[i % 4]);
+    for (int i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) contentsKept = false;
+    }
+
+    printf("Heap handle contents test : ");
+    if (contentsKept == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Heap handle coalescing test : ");
+    for (int i = 0; i < 4; i++)
+    {
+        Node *node = (Node *)(heaps[i]);
+        if (node->free == false || node->size != size - sizeof(Node) || node->next != node) coalesced = false;
+
+        mm_destroy(managers[i]);
+        free(heaps[i]);
+    }
+    if (coalesced == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* Options only apply to the heap they are passed to, so a heap created after them still has one arena */
+    MemoryOptions options = {.arenas = 4, .lockPolicy = "Spin"};
+    heaps[0] = malloc(size);
+    heaps[1] = malloc(size);
+    managers[0] = mm_create_ex(heaps[0], size, "FirstFit", &options);
+    managers[1] = mm_create_ex(heaps[1], size, "FirstFit", NULL);
+
+    printf("Heap handle options test : ");
+    Node *split = (Node *)(heaps[0] + size / 4);
+    Node *whole = (Node *)(heaps[1]);
+    if (managers[0] != NULL && split->free == true && split->size == size / 4 - sizeof(Node) && split->next == split &&
+        managers[1] != NULL && whole->size == size - sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    for (int i = 0; i < 2; i++)
+    {
+        mm_destroy(managers[i]);
+        free(heaps[i]);
+    }
+}
+
+/**
+ * Thread body for the pool test that repeatedly allocates and frees objects from a pool, writing to each one so that
+ * objects handed out twice would be noticed.
+ *
+ * @param argument - pool to be used
+ * @return - NULL if every object held its contents/non NULL otherwise
+ */
+void *poolWorker(void *argument)
+{
+    Pool *pool = (Pool *)(argument);
+    unsigned char *objects[16] = {NULL};
+    void *result = NULL;
+
+    for (int i = 0; i < 5000; i++)
+    {
+        int slot = i % 16;
+
+        if (objects[slot] != NULL)
+        {
+            for (int j = 0; j < 32; j++) if (objects[slot][j] != (unsigned char)(slot)) result = argument;
+            pool_free(pool, objects[slot]);
+        }
+        objects[slot] = pool_alloc(pool);
+        if (objects[slot] != NULL) memset(objects[slot], slot, 32);
+    }
+    for (int slot = 0; slot < 16; slot++) pool_free(pool, objects[slot]);
+    return result;
+}
+
+/**
+ * Function that tests that a pool hands out each object to only one thread at a time, that destroying the pool
+ * gives all of its slabs back to the heap, and that a pool created on a heap handle uses that heap.
+ */
+void poolTest()
+{
+    void *returnValue;
+    bool_type contentsKept = true;
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
+
+    initialise(heap, size, "FirstFit");
+    Pool *pool = pool_create(32);
+
+    for (int i = 0; i < 8; i++) pthread_create(&(threads[i]), NULL, &poolWorker, pool);
+    for (int i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) contentsKept = false;
+    }
+
+    printf("Pool contents test : ");
+    if (contentsKept == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    pool_destroy(pool);
+
+    printf("Pool destroy test : ");
+    Node *node = (Node *)(heap);
+    if (node->free == true && node->size == size - sizeof(Node) && node->next == node) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* A pool on a heap handle takes its slabs from that heap, not the one set up by initialise */
+    void *other = malloc(size);
+    MemoryManager *manager = mm_create(other, size, "BestFit");
+    pool = mm_pool_create(manager, 48);
+
+    printf("Pool heap handle test : ");
+    char *object = pool_alloc(pool);
+    bool_type inHeap = ((void *)(object) > other && (void *)(object) < other + size && node->free == true &&
+                        node->size == size - sizeof(Node)) ? true : false;
+    pool_free(pool, object);
+    pool_destroy(pool);
+    if (inHeap == true && mm_allocate(manager, size - sizeof(Node)) == other + sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(other);
+    free(heap);
+}
+
+/**
+ * Function that tests that small requests are packed into chunks of the small block tier without nodes, that threads
+ * using both the tier and the list at once keep their blocks apart, and that everything is freed afterwards.
+ */
+void smallBlockTest()
+{
+    void *returnValue;
+    bool_type contentsKept = true;
+    size_t size = 1 << 18;
+    void *heap = malloc(size);
+
+    memoryManager_smallBlocks(true);
+    initialise(heap, size, "FirstFit");
+
+    printf("Small block packing test : ");
+    char *first = allocate(8);
+    char *second = allocate(8);
+    char *third = allocate(40);
+    if (second - first == 8 && third >= (char *)(heap) + size - size / 4 && third < (char *)(heap) + size) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    deallocate(first);
+    deallocate(second);
+    deallocate(third);
+
+    for (int i = 0; i < 8; i++) pthread_create(&(threads[i]), NULL, &cacheWorker, heap);
+    for (int i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) contentsKept = false;
+    }
+
+    printf("Small block contents test : ");
+    if (contentsKept == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* Every 8 byte chunk must be free again, so they can all be allocated before one comes from the list */
+    printf("Small block deallocating test : ");
+    size_t chunks = 0;
+    for (char *chunk = allocate(8); chunk >= (char *)(heap) + size - size / 4; chunk = allocate(8)) chunks++;
+    Node *node = (Node *)(heap);
+    if (node->next->next == node && chunks == size / 4 / 4 / 8) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    memoryManager_smallBlocks(false);
+    free(heap);
+}
+
+/**
+ * Function that tests that compact blocks only carry a size_t in front of them, and that freed blocks are joined with
+ * free blocks either side of them using their headers and footers, with threads or without.
+ */
+void compactTest()
+{
+    void *returnValue;
+    bool_type contentsKept = true;
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
+    size_t whole = size - 2 * sizeof(size_t); // Less the header of the block and the header ending the heap
+
+    initialise(heap, size, "Compact");
+
+    printf("Compact allocating test : ");
+    char *first = allocate(40);
+    char *second = allocate(20);
+    char *third = allocate(1);
+    if (second - first == 40 + sizeof(size_t) && third - second == 24 + sizeof(size_t)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* The second block joins the block after it, then the first block finds it through its footer */
+    deallocate(second);
+    deallocate(first);
+    printf("Compact coalescing test : ");
+    if (allocate(64) == first) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    deallocate(first);
+    deallocate(third);
+
+    for (int i = 0; i < 8; i++) pthread_create(&(threads[i]), NULL, &cacheWorker, heap);
+    for (int i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) contentsKept = false;
+    }
+
+    printf("Compact thread test : ");
+    if (contentsKept == true && memoryManager_largestFree() == whole) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Thread body for the aligned allocation test that allocates blocks on alignments of 8 up to 4096 bytes, checking each
+ * address and writing to each block so that overlapping blocks would be noticed.
+ *
+ * @param argument - unused
+ * @return - NULL if every block was aligned and held its contents/non NULL otherwise
+ */
+void *alignedWorker(void *argument)
+{
+    void *blocks[8] = {NULL};
+    void *result = NULL;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        int slot = i % 8;
+        size_t alignment = (size_t)(8) << (i % 10);
+
+        if (blocks[slot] != NULL)
+        {
+            if (*(unsigned char *)(blocks[slot]) != (unsigned char)(slot)) result = argument;
+            deallocate(blocks[slot]);
+        }
+        blocks[slot] = allocate_aligned(1 + (i * 29) % 300, alignment);
+        if (blocks[slot] == NULL) continue;
+
+        if ((size_t)(blocks[slot]) % alignment != 0) result = argument;
+        memset(blocks[slot], slot, 1 + (i * 29) % 300);
+    }
+    for (int slot = 0; slot < 8; slot++) deallocate(blocks[slot]);
+    return result;
+}
+
+/**
+ * Function that tests aligned allocation from many threads, checking that the gaps freed around aligned blocks are
+ * joined back into a single node once everything is deallocated and that every alignment can then be met.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void alignedThreadTest(char *algorithm)
+{
+    void *returnValue;
+    bool_type aligned = true;
+    size_t size = 1 << 18;
+    void *heap = malloc(size);
+
+    initialise(heap, size, algorithm);
+
+    for (int i = 0; i < 8; i++) pthread_create(&(threads[i]), NULL, &alignedWorker, heap);
+    for (int i = 0; i < 8; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) aligned = false;
+    }
+
+    printf("Aligned allocation test : ");
+    if (aligned == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Aligned coalescing test : ");
+    if (memoryManager_largestFree() + 2 * sizeof(Node) > size) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* The workers skip requests that fail, so make sure none of the alignments they use fail on an empty heap */
+    printf("Aligned empty heap test : ");
+    for (size_t alignment = 8; alignment <= 4096; alignment <<= 1)
+    {
+        void *block = allocate_aligned(100, alignment);
+        if (block == NULL || (size_t)(block) % alignment != 0 || usable_size(block) < 100) aligned = false;
+        deallocate(block);
+    }
+    if (aligned == true && memoryManager_largestFree() + 2 * sizeof(Node) > size) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that tests that reallocation grows a block into a free node after it and shrinks it in place, only moving
+ * it when the node after it is in use, and that its contents are kept either way.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void reallocateTest(char *algorithm)
+{
+    size_t size = 1 << 14;
+    void *heap = malloc(size);
+
+    initialise(heap, size, algorithm);
+
+    char *test1 = allocate(100);
+    char *test2 = allocate(100);
+    memset(test1, 1, 100);
+    deallocate(test2);
+
+    printf("Reallocate growing test : ");
+    char *grown = reallocate(test1, 200);
+    if (grown == test1 && usable_size(grown) >= 200 && grown[99] == 1) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Reallocate shrinking test : ");
+    char *shrunk = reallocate(grown, 50);
+    if (shrunk == test1 && usable_size(shrunk) >= 50 && usable_size(shrunk) < 100 && shrunk[49] == 1) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* The node after is now in use, so growing must move the block */
+    char *test3 = allocate(100);
+    printf("Reallocate moving test : ");
+    char *moved = reallocate(shrunk, 1000);
+    if (moved != NULL && moved != shrunk && usable_size(moved) >= 1000 && moved[0] == 1 && moved[49] == 1)
+    {
+        printf("Passed!\n");
+    }
+    else printf("Failed!\n");
+
+    deallocate(moved);
+    deallocate(test3);
+
+    printf("Reallocate coalescing test : ");
+    if (memoryManager_largestFree() + 2 * sizeof(Node) > size) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* Growing into, and later freeing next to, the only other node must leave a list of one node pointing at itself */
+    if (strcmp(algorithm, "Compact") != 0)
+    {
+        Node *node = (Node *)(heap);
+
+        printf("Reallocate two node test : ");
+        char *whole = reallocate(allocate(100), size - sizeof(Node));
+        bool_type linked = (whole == heap + sizeof(Node) && node->next == node && node->prev == node);
+
+        reallocate(whole, 100);
+        deallocate(whole);
+        if (linked == true && node->free == true && node->next == node && node->prev == node &&
+            listTest(node, heap + sizeof(Node), size) == true) printf("Passed!\n");
+        else printf("Failed!\n");
+    }
+
+    free(heap);
+}
+
+/**
+ * Function that tests that shrinking a buddy block halves it in place, releasing the upper halves so that they can be
+ * allocated, and that they merge back once it is freed.
+ */
+void buddyReallocateTest()
+{
+    size_t size = 1 << 14;
+    void *heap = malloc(size);
+
+    initialise(heap, size, "Buddy");
+
+    char *test1 = allocate(1000);
+    memset(test1, 1, 1000);
+
+    printf("Buddy reallocate shrinking test : ");
+    char *shrunk = reallocate(test1, 100);
+    if (shrunk == test1 && usable_size(shrunk) >= 100 && usable_size(shrunk) < 1000 && shrunk[99] == 1)
+    {
+        printf("Passed!\n");
+    }
+    else printf("Failed!\n");
+
+    /* The upper half of the old block is the only free block of its order */
+    printf("Buddy reallocate freed half test : ");
+    char *half = allocate(900);
+    if (half == test1 + 1024) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    deallocate(half);
+    deallocate(shrunk);
+
+    printf("Buddy reallocate coalescing test : ");
+    if (memoryManager_largestFree() + sizeof(Node) == size) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that tests that callocate leaves blocks of a heap declared zeroed as they are, only clearing what was
+ * written to them while free, that it clears blocks which have been deallocated, whether they were cached or pushed onto
+ * a lock-free class, and that it fails on overflow.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void callocateTest(char *algorithm)
+{
+    size_t size = 1 << 14;
+    char *heap = calloc(1, size);
+
+    memoryManager_zeroedMemory(true);
+    initialise(heap, size, algorithm);
+    memoryManager_zeroedMemory(false);
+
+    /* Nothing can write here while the heap is untouched, so the byte is only still set if clearing was skipped */
+    heap[size / 8] = 1;
+
+    printf("Callocate zeroed memory test : ");
+    char *test1 = callocate(1, size / 4);
+    if (test1 != NULL && test1[size / 8 - (test1 - heap)] == 1 && test1[0] == 0) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    memset(test1, 1, size / 4);
+    deallocate(test1);
+
+    printf("Callocate recycled memory test : ");
+    char *test2 = callocate(size / 64, 16);
+    size_t i = 0;
+    while (test2 != NULL && i < size / 4 && test2[i] == 0) i++;
+    if (i == size / 4) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Callocate overflow test : ");
+    if (callocate((size_t)(-1) / 2 + 2, 2) == NULL) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    deallocate(test2);
+
+    /* A block in the thread's cache keeps what was written to it, so callocate must clear it or pass it over */
+    memset(heap, 0, size);
+    MemoryOptions options = {.zeroedMemory = true, .threadCache = true};
+    MemoryManager *manager = mm_create_ex(heap, size, algorithm, &options);
+
+    printf("Callocate cached memory test : ");
+    char *test3 = mm_allocate(manager, 96);
+    memset(test3, 0xAB, 96);
+    mm_deallocate(manager, test3); // Goes to the thread's cache
+    char *test4 = mm_callocate(manager, 1, 96);
+    i = 0;
+    while (test4 != NULL && i < 96 && test4[i] == 0) i++;
+    if (i == 96 && mm_allocate(manager, 96) == test3) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+
+    /* The same goes for a block from a batch, which never went through a class, pushed onto a lock-free class */
+    memset(heap, 0, size);
+    options = (MemoryOptions){.zeroedMemory = true, .lockFreeClasses = true};
+    manager = mm_create_ex(heap, size, algorithm, &options);
+
+    printf("Callocate lock-free class test : ");
+    size_t sizes[1] = {96};
+    mm_allocate_batch(manager, sizes, 1, (void **)(&test3));
+    memset(test3, 0xAB, 96);
+    mm_deallocate(manager, test3); // Goes to the lock-free class
+    test4 = mm_callocate(manager, 1, 96);
+    i = 0;
+    while (test4 != NULL && i < 96 && test4[i] == 0) i++;
+    if (i == 96 && test4 == test3) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* Aligned blocks skip the classes as well, and every block of the heap is already on this alignment */
+    printf("Callocate aligned lock-free class test : ");
+    test3 = mm_allocate_aligned(manager, 96, 16);
+    memset(test3, 0xAB, 96);
+    mm_deallocate(manager, test3);
+    test4 = mm_callocate(manager, 1, 96);
+    i = 0;
+    while (test4 != NULL && i < 96 && test4[i] == 0) i++;
+    if (i == 96 && test4 == test3) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(heap);
+}
+
+/**
+ * Function that tests that a batch of blocks can be allocated at once, with any that don't fit left NULL, and that
+ * deallocating the batch in any order joins the blocks back into a single free node, leaving the caller's array as it
+ * was whether the batch is small enough to be sorted on the stack or not.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void batchTest(char *algorithm)
+{
+    size_t size = 1 << 14;
+    void *heap = malloc(size);
+    size_t sizes[8] = {100, 16, 300, size * 2, 48, 1000, 8, 200};
+    void *memory[8];
+
+    initialise(heap, size, algorithm);
+
+    printf("Allocate batch test : ");
+    size_t allocated = allocate_batch(sizes, 8, memory);
+    int valid = (allocated == 7 && memory[3] == NULL);
+    for (size_t i = 0; i < 8; i++)
+    {
+        if (memory[i] != NULL && usable_size(memory[i]) < sizes[i]) valid = 0;
+        if (memory[i] != NULL) memset(memory[i], (int)(i), sizes[i]);
+    }
+    for (size_t i = 0; i < 8; i++) if (memory[i] != NULL && ((char *)(memory[i]))[sizes[i] - 1] != (char)(i)) valid = 0;
+    if (valid == 1) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* Swap the pointers around so that the batch isn't already in address order */
+    void *swap = memory[0];
+    memory[0] = memory[7];
+    memory[7] = swap;
+    swap = memory[2];
+    memory[2] = memory[5];
+    memory[5] = swap;
+
+    printf("Deallocate batch test : ");
+    void *order[8];
+    memcpy(order, memory, sizeof(order));
+    deallocate_batch(memory, 8);
+    if (memoryManager_largestFree() + 2 * sizeof(Node) > size && memcmp(order, memory, sizeof(order)) == 0)
+    {
+        printf("Passed!\n");
+    }
+    else printf("Failed!\n");
+
+    /* Too many to be sorted on the stack, and handed over in reverse so that the copy has to be sorted */
+    size_t many[100];
+    void *blocks[100];
+    for (size_t i = 0; i < 100; i++) many[i] = 16;
+    allocate_batch(many, 100, blocks);
+    for (size_t i = 0; i < 50; i++)
+    {
+        void *swap = blocks[i];
+        blocks[i] = blocks[99 - i];
+        blocks[99 - i] = swap;
+    }
+    void *first = blocks[0];
+
+    printf("Deallocate large batch test : ");
+    deallocate_batch(blocks, 100);
+    if (memoryManager_largestFree() + 2 * sizeof(Node) > size && blocks[0] == first) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    free(heap);
+}
+
+/**
+ * Function that tests that a growable heap maps segments once its buffer is full, including for requests bigger than
+ * a segment would normally be, and that deallocating everything leaves the buffer whole without joining it to them.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void growableTest(char *algorithm)
+{
+    size_t size = 1 << 12;
+    void *heap = malloc(size);
+    char *memory[100];
+
+    memoryManager_growable(true);
+    initialise(heap, size, algorithm);
+    memoryManager_growable(false);
+
+    printf("Growable heap test : ");
+    int valid = 1;
+    for (int i = 0; i < 100; i++)
+    {
+        memory[i] = allocate(1000);
+        if (memory[i] == NULL) valid = 0;
+        else memset(memory[i], i, 1000);
+    }
+    for (int i = 0; i < 100; i++) if (memory[i] != NULL && (memory[i][0] != i || memory[i][999] != i)) valid = 0;
+    if (valid == 1) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Growable large request test : ");
+    char *large = allocate(1 << 24);
+    if (large != NULL)
+    {
+        large[(1 << 24) - 1] = 1;
+        printf("Passed!\n");
+    }
+    else printf("Failed!\n");
+
+    for (int i = 0; i < 100; i++) deallocate(memory[i]);
+    deallocate(large);
+
+    printf("Growable coalescing test : ");
+    char *whole = allocate(size - sizeof(Node));
+    if (whole == (char *)(heap) + sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    initialise(heap, size, "FirstFit"); // Unmaps the segments before the buffer is freed
+    free(heap);
+}
+
+/**
+ * Function that tests that the pages of big free nodes of a mapped heap are given back as memory is deallocated once
+ * past the trim threshold, and by mm_trim otherwise, by checking that they come back as zero when used again. Freeing
+ * a block between nodes that were already trimmed must only trim that block, leaving the pages of the others alone.
+ * Memory given to mm_create must never be trimmed, so that callocate still clears it.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void trimTest(char *algorithm)
+{
+    size_t size = 1 << 21;
+    size_t bytes = 1 << 18;
+    MemoryOptions options = {.trimThreshold = 1 << 16};
+    MemoryManager *manager = mm_create_mapped_ex(size, algorithm, &options);
+
+    char *test1 = mm_allocate(manager, bytes);
+    memset(test1, 1, bytes);
+    mm_deallocate(manager, test1);
+
+    printf("Trim on deallocate test : ");
+    char *test2 = mm_allocate(manager, bytes);
+    size_t i = 2 * sizeof(Node *); // Skips any links written while the node was free
+    while (test2 != NULL && i < bytes && test2[i] == 0) i++;
+    if (test2 == test1 && i == bytes) printf("Passed!\n");
+    else printf("Failed!\n");
+    mm_destroy(manager);
+
+    manager = mm_create_mapped(size, algorithm);
+    test1 = mm_allocate(manager, bytes);
+    memset(test1, 1, bytes);
+    mm_deallocate(manager, test1);
+
+    printf("Explicit trim test : ");
+    size_t trimmed = mm_trim(manager);
+    test2 = mm_allocate(manager, bytes);
+    i = 2 * sizeof(Node *);
+    while (test2 != NULL && i < bytes && test2[i] == 0) i++;
+    if (trimmed >= bytes && test2 == test1 && i == bytes) printf("Passed!\n");
+    else printf("Failed!\n");
+    mm_destroy(manager);
+
+    manager = mm_create_mapped_ex(size, algorithm, &options);
+    test1 = mm_allocate(manager, bytes - sizeof(Node));
+    char *test3 = mm_allocate(manager, 1 << 14); // Big enough to hold whole pages, but below the threshold
+    char *test4 = mm_allocate(manager, bytes - sizeof(Node));
+    memset(test1, 1, bytes - sizeof(Node));
+    memset(test3, 1, 1 << 14);
+    memset(test4, 1, bytes - sizeof(Node));
+    mm_deallocate(manager, test1);
+    mm_deallocate(manager, test4);
+
+    /* The heap takes the trimmed node to be zero, so the byte is only still set if its pages were left alone */
+    test1[bytes / 2] = 1;
+    mm_deallocate(manager, test3);
+
+    printf("Trim on coalescing test : ");
+    char *end = test4 + bytes - sizeof(Node);
+    char *byte = test1 + sizeof(Node); // Skips the links of the joined node
+    while (byte < end && (*byte == 0 || byte == test1 + bytes / 2)) byte++;
+    if (byte == end && test1[bytes / 2] == 1) printf("Passed!\n");
+    else printf("Failed!\n");
+    mm_destroy(manager);
+
+    void *heap = malloc(size);
+    manager = mm_create_ex(heap, size, algorithm, &options);
+    test1 = mm_allocate(manager, bytes);
+    memset(test1, 1, bytes);
+    mm_deallocate(manager, test1);
+
+    printf("Trim given memory test : ");
+    trimmed = mm_trim(manager);
+    bool_type kept = (test1[bytes / 2] == 1) ? true : false;
+    test2 = mm_callocate(manager, 1, bytes);
+    i = 0;
+    while (test2 != NULL && i < bytes && test2[i] == 0) i++;
+    if (trimmed == 0 && kept == true && test2 == test1 && i == bytes) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(heap);
+}
+
+/**
+ * Function that tests that a heap mapping its own memory starts on a huge page boundary and is rounded up to a whole
+ * number of huge pages, and that the heap used by allocate can be mapped the same way.
+ */
+void mappedHeapTest()
+{
+    size_t hugePage = 2 * 1024 * 1024;
+    MemoryManager *heap = mm_create_mapped(hugePage + 1, "FirstFit");
+
+    printf("Mapped heap test : ");
+    char *test1 = mm_allocate(heap, 2 * hugePage - sizeof(Node));
+    if (test1 != NULL && ((size_t)(test1) - sizeof(Node)) % hugePage == 0)
+    {
+        test1[2 * hugePage - sizeof(Node) - 1] = 1;
+        printf("Passed!\n");
+    }
+    else printf("Failed!\n");
+    mm_destroy(heap);
+
+    initialise_mapped(hugePage, "TLSF");
+
+    printf("Mapped initialise test : ");
+    char *test2 = callocate(100, 10);
+    size_t i = 0;
+    while (test2 != NULL && i < 1000 && test2[i] == 0) i++;
+    if (i == 1000) printf("Passed!\n");
+    else printf("Failed!\n");
+    deallocate(test2);
+}
+
+/**
+ * Function that tests that requests past the map threshold are given mappings of their own, leaving the heap alone
+ * even when they wouldn't fit in it, and that they keep their contents when reallocated.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void mapThresholdTest(char *algorithm)
+{
+    size_t size = 1 << 14;
+    void *heap = malloc(size);
+
+    memoryManager_mapThreshold(1 << 16);
+    initialise(heap, size, algorithm);
+    memoryManager_mapThreshold(0);
+
+    printf("Mapped block test : ");
+    char *test1 = allocate(1 << 20);
+    if (test1 != NULL && memoryManager_largestFree() + 2 * sizeof(Node) > size)
+    {
+        memset(test1, 1, 1 << 20);
+        printf("Passed!\n");
+    }
+    else printf("Failed!\n");
+
+    printf("Mapped reallocate test : ");
+    char *test2 = (test1 != NULL) ? reallocate(test1, 1 << 22) : NULL;
+    if (test2 != NULL && usable_size(test2) >= (1 << 22) && test2[0] == 1 && test2[(1 << 20) - 1] == 1)
+    {
+        test2[(1 << 22) - 1] = 1;
+        printf("Passed!\n");
+    }
+    else printf("Failed!\n");
+    deallocate(test2);
+
+    printf("Mapped callocate test : ");
+    char *test3 = callocate(1 << 10, 1 << 10);
+    size_t i = 0;
+    while (test3 != NULL && i < (1 << 20) && test3[i] == 0) i++;
+    if (i == (1 << 20) && memoryManager_largestFree() + 2 * sizeof(Node) > size) printf("Passed!\n");
+    else printf("Failed!\n");
+    deallocate(test3);
+
+    free(heap);
+}
+
+/**
+ * Function that tests that deallocation with deferred coalescing leaves blocks pending until an allocation can't find
+ * room without them, and that the sweeper releases them by itself.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void deferredTest(char *algorithm)
+{
+    size_t size = 1 << 14;
+    void *heap = malloc(size);
+
+    memoryManager_deferredCoalescing(true);
+    initialise(heap, size, algorithm);
+
+    void *test1 = allocate(size / 4);
+    void *test2 = allocate(size / 4);
+    deallocate(test1);
+    deallocate(test2);
+
+    printf("Deferred deallocate test : ");
+    if (memoryManager_largestFree() < size / 2) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("Deferred coalescing test : ");
+    void *test3 = allocate(size - 2 * sizeof(Node) - 64);
+    if (test3 != NULL) printf("Passed!\n");
+    else printf("Failed!\n");
+    deallocate(test3);
+
+    memoryManager_sweeper(1);
+    initialise(heap, size, algorithm);
+    memoryManager_sweeper(0);
+    memoryManager_deferredCoalescing(false);
+
+    deallocate(allocate(size / 2));
+
+    printf("Sweeper test : ");
+    for (int i = 0; i < 1000 && memoryManager_largestFree() + 2 * sizeof(Node) <= size; i++) usleep(1000);
+    if (memoryManager_largestFree() + 2 * sizeof(Node) > size) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    initialise(heap, size, "FirstFit"); // Stops the sweeper before the heap is freed
+    free(heap);
+}
+
+/**
+ * Runs threads on a heap at once, each allocating and deallocating blocks of its own with heapWorker.
+ *
+ * @param manager - heap to be used
+ * @param threadCount - number of threads to be run
+ * @return - true if every block held its contents/false otherwise
+ */
+bool_type heapThreads(MemoryManager *manager, int threadCount)
+{
+    void *returnValue;
+    bool_type contentsKept = true;
+
+    for (int i = 0; i < threadCount; i++) pthread_create(&(threads[i]), NULL, &heapWorker, manager);
+    for (int i = 0; i < threadCount; i++)
+    {
+        pthread_join(threads[i], &returnValue);
+        if (returnValue != NULL) contentsKept = false;
+    }
+    return contentsKept;
+}
+
+/**
+ * Fixture shared by the tests of the threading features, which creates a heap with the given options and runs threads
+ * on it, checking that every block held its contents and, once mm_trim has released any blocks left pending or in
+ * size classes, that each arena is left as a single free node. The heap is left for the checks of the feature itself.
+ *
+ * @param name - name of the feature printed before each test
+ * @param heap - memory of the heap
+ * @param size - size of heap in bytes
+ * @param algorithm - algorithm to be used by the test memory manager
+ * @param options - settings of the heap
+ * @param threadCount - number of threads to be run
+ * @return - the heap, to be destroyed by the caller
+ */
+MemoryManager *heapFixture(char *name, void *heap, size_t size, char *algorithm, MemoryOptions *options,
+                           int threadCount)
+{
+    size_t count = (options->arenas == 0) ? 1 : options->arenas;
+    bool_type coalesced = true;
+    MemoryManager *manager = mm_create_ex(heap, size, algorithm, options);
+    bool_type contentsKept = heapThreads(manager, threadCount);
+
+    printf("%s contents test : ", name);
+    if (contentsKept == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_trim(manager);
+
+    printf("%s coalescing test : ", name);
+    for (size_t i = 0; i < count; i++)
+    {
+        Node *node = (Node *)(heap + i * (size / count));
+        if (node->free == false || node->size != size / count - sizeof(Node) || node->next != node) coalesced = false;
+    }
+    if (coalesced == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    return manager;
+}
+
+/**
+ * Function that tests a lock policy by running threads on one heap with a single arena guarded by it, so that they
+ * all fight over the same lock. The threads are then run on a heap with four arenas, where they try each other's
+ * locks without waiting before moving on, and blocks that each nearly fill an arena check that a thread can take
+ * every arena's lock in turn. With no lock only one thread is run.
+ *
+ * @param policy - lock to be used by the test memory manager
+ */
+void lockPolicyTest(char *policy)
+{
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
+    void *blocks[4];
+    char name[64];
+    bool_type spilled = true;
+    int threadCount = strcmp(policy, "None") ? 8 : 1;
+
+    MemoryOptions options = {.lockPolicy = policy};
+    sprintf(name, "%s lock", policy);
+    mm_destroy(heapFixture(name, heap, size, "FirstFit", &options, threadCount));
+
+    options.arenas = 4;
+    sprintf(name, "%s lock arenas", policy);
+    MemoryManager *manager = heapFixture(name, heap, size, "FirstFit", &options, threadCount);
+
+    printf("%s lock spill test : ", policy);
+    for (int i = 0; i < 4; i++)
+    {
+        blocks[i] = mm_allocate(manager, size / 4 - 2 * sizeof(Node));
+        if (blocks[i] == NULL) spilled = false;
+    }
+    if (spilled == true) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(heap);
+}
+
+/**
+ * Function that tests flat combining by running threads on one heap with a single arena, so that most of their
+ * requests are carried out by whichever of them holds the lock, checking that some were.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void combiningTest(char *algorithm)
+{
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
+    char name[64];
+    bool_type contentsKept = true;
+
+    MemoryOptions options = {.flatCombining = true};
+    sprintf(name, "%s combining", algorithm);
+    MemoryManager *manager = heapFixture(name, heap, size, algorithm, &options, 8);
+
+    /* Threads only wait on a combiner when they overlap, which on a single processor takes a preemption */
+    for (int round = 0; round < 100 && mm_combined(manager) == 0; round++)
+    {
+        if (heapThreads(manager, 8) == false) contentsKept = false;
+    }
+
+    printf("%s combining served test : ", algorithm);
+    if (contentsKept == true && mm_combined(manager) > 0) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(heap);
+}
+
+/**
+ * Function that tests lock-free size classes by running threads on one heap whose small blocks all go through them,
+ * then checking that a freed block stays in its class and that a request too big for any class empties the classes
+ * back into the list so that it can be served.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void lockFreeClassTest(char *algorithm)
+{
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
+    char name[64];
+
+    MemoryOptions options = {.lockFreeClasses = true};
+    sprintf(name, "%s lock-free class", algorithm);
+    MemoryManager *manager = heapFixture(name, heap, size, algorithm, &options, 8);
+
+    printf("%s lock-free class reuse test : ", algorithm);
+    void *first = mm_allocate(manager, 40);
+    size_t usable = mm_usable_size(manager, first);
+    mm_deallocate(manager, first);
+    if (mm_allocate(manager, usable) == first) printf("Passed!\n"); // The block is still in the class, not coalesced
+    else printf("Failed!\n");
+    mm_deallocate(manager, first);
+
+    /* Fill the heap with blocks of one class and hand them all back, so only draining the class leaves room */
+    void *blocks[1024];
+    int count = 0;
+    while (count < 1024 && (blocks[count] = mm_allocate(manager, 64)) != NULL) count++;
+    for (int i = 0; i < count; i++) mm_deallocate(manager, blocks[i]);
+
+    printf("%s lock-free class drain test : ", algorithm);
+    void *big = mm_allocate(manager, size / 2);
+    if (count < 1024 && big != NULL) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(heap);
+}
+
+/**
+ * Thread body for the remote free test that deallocates a block from a heap it has never allocated from.
+ *
+ * @param argument - array of the heap and the block to be deallocated
+ * @return - NULL
+ */
+void *remoteWorker(void *argument)
+{
+    void **arguments = (void **)(argument);
+
+    mm_deallocate((MemoryManager *)(arguments[0]), arguments[1]);
+    return NULL;
+}
+
+/**
+ * Thread body for the remote free test that checks and deallocates every block in one row of the handoff blocks,
+ * which other threads allocated, then allocates new blocks into the row for the thread of the next round.
+ *
+ * @param argument - array of the heap, the rows of handoff blocks and the row to be used
+ * @return - NULL if every block held its contents/non NULL otherwise
+ */
+void *handoffWorker(void *argument)
+{
+    void **arguments = (void **)(argument);
+    MemoryManager *manager = (MemoryManager *)(arguments[0]);
+    void **row = (void **)(arguments[1]) + (size_t)(arguments[2]) * 32;
+    unsigned char mark = (unsigned char)(size_t)(arguments[2]);
+    void *result = NULL;
+
+    for (int i = 0; i < 32; i++)
+    {
+        if (row[i] != NULL && *(unsigned char *)(row[i]) != mark) result = argument;
+        mm_deallocate(manager, row[i]);
+
+        row[i] = mm_allocate(manager, 1 + (i * 37) % 200);
+        if (row[i] != NULL) memset(row[i], mark, 1 + (i * 37) % 200);
+    }
+    return result;
+}
+
+/**
+ * Function that tests remote frees on a heap with two arenas, first with the shared fixture and then on a fresh heap
+ * checking that a block deallocated by a thread given the other arena is left pending rather than released, and that
+ * the owning thread's next allocation releases it. Rounds of threads then hand blocks to each other while the calling
+ * thread works on the heap as well, after which its allocations must still come from its own arena and the pending
+ * blocks of both arenas must coalesce.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void remoteFreeTest(char *algorithm)
+{
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
+    char name[64];
+
+    MemoryOptions options = {.arenas = 2, .remoteFrees = true};
+    sprintf(name, "%s remote free threads", algorithm);
+    mm_destroy(heapFixture(name, heap, size, algorithm, &options, 8));
+
+    MemoryManager *manager = mm_create_ex(heap, size, algorithm, &options);
+
+    void *arguments[2] = {manager, mm_allocate(manager, 100)}; // The calling thread is given the first arena
+    Node *node = (Node *)(arguments[1] - sizeof(Node));
+
+    pthread_create(&(threads[0]), NULL, &remoteWorker, arguments); // While the thread is given the second
+    pthread_join(threads[0], NULL);
+
+    printf("%s remote free pending test : ", algorithm);
+    if (node->free == false) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    printf("%s remote free drain test : ", algorithm);
+    void *memory = mm_allocate(manager, 100);
+    if (memory == arguments[1] && node->free == false) printf("Passed!\n"); // Released, then allocated again
+    else printf("Failed!\n");
+    mm_deallocate(manager, memory);
+
+    printf("%s remote free coalescing test : ", algorithm);
+    if (node->free == true && node->size == size / 2 - sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    /* Each round's threads are given arenas in turn, so most blocks are deallocated by a thread of the other arena */
+    void *rows[4 * 32] = {NULL};
+    void *handoffs[4][3];
+    void *returnValue;
+    bool_type contentsKept = true;
+
+    for (int round = 0; round < 8; round++)
+    {
+        for (size_t i = 0; i < 4; i++)
+        {
+            handoffs[i][0] = manager;
+            handoffs[i][1] = rows;
+            handoffs[i][2] = (void *)((i + round) % 4);
+            pthread_create(&(threads[i]), NULL, &handoffWorker, handoffs[i]);
+        }
+        if (heapWorker(manager) != NULL) contentsKept = false;
+        for (int i = 0; i < 4; i++)
+        {
+            pthread_join(threads[i], &returnValue);
+            if (returnValue != NULL) contentsKept = false;
+        }
+    }
+
+    printf("%s remote free handoff test : ", algorithm);
+    memory = mm_allocate(manager, 100);
+    if (contentsKept == true && memory != NULL && memory < heap + size / 2) printf("Passed!\n"); // Still its own arena
+    else printf("Failed!\n");
+    mm_deallocate(manager, memory);
+
+    for (int i = 0; i < 4 * 32; i++) mm_deallocate(manager, rows[i]);
+    mm_trim(manager); // Releases whatever is still pending
+
+    printf("%s remote free handoff coalescing test : ", algorithm);
+    Node *second = (Node *)(heap + size / 2);
+    if (node->free == true && node->size == size / 2 - sizeof(Node) && second->free == true &&
+        second->size == size / 2 - sizeof(Node)) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(heap);
+}
+
+/**
+ * Function that tests region locking by running threads on one heap whose arena is split into many small regions, so
+ * that the threads' searches and deallocations keep crossing from one region to the next, checking that the requests
+ * were carried out under region locks.
+ *
+ * @param algorithm - algorithm to be used by the test memory manager
+ */
+void regionLockingTest(char *algorithm)
+{
+    size_t size = 1 << 16;
+    void *heap = malloc(size);
+    char name[64];
+
+    MemoryOptions options = {.regionLocking = true};
+    sprintf(name, "%s region locking", algorithm);
+    MemoryManager *manager = heapFixture(name, heap, size, algorithm, &options, 8);
+
+    /* The heap is never close to full, so every deallocation, and all but the rare failed search, stay on regions */
+    printf("%s region locking served test : ", algorithm);
+    if (mm_region_served(manager) >= 8 * 2000) printf("Passed!\n");
+    else printf("Failed!\n");
+
+    mm_destroy(manager);
+    free(heap);
+}
+
+/**
+ * Function that tests each algorithm individually.
+ */
+void testHarness()
+{
+    printf("---------- Testing Begins ----------\n");
+
+    printf(" -- As all the algorithms are based off of part 2, the only test necessary for them is that their "
+           "algorithm operates correctly with threads -- \n ");
+
+    printf("\n---------- Begin First Fit Test ----------\n");
+    threadTest("FirstFit");
+    printf("\n---------- End First Fit Test ----------\n");
+
+    printf("\n---------- Begin Best Fit Test ----------\n");
+    threadTest("BestFit");
+    bestFitTreeTest();
+    printf("\n---------- End Best Fit Test ----------\n");
+
+    printf("\n---------- Begin Worst Fit Test ----------\n");
+    threadTest("WorstFit");
+    worstFitHeapTest();
+    printf("\n---------- End Worst Fit Test ----------\n");
+
+    printf("\n---------- Begin Next Fit Test ----------\n");
+    threadTest("NextFit");
+    printf("\n---------- End Next Fit Test ----------\n");
+
+    printf("\n---------- Begin Segregated Fit Test ----------\n");
+    threadTest("SegregatedFit");
+    threadCacheTest("SegregatedFit");
+    printf("\n---------- End Segregated Fit Test ----------\n");
+
+    printf("\n---------- Begin TLSF Test ----------\n");
+    threadTest("TLSF");
+    threadCacheTest("TLSF");
+    tlsfListTest();
+    printf("\n---------- End TLSF Test ----------\n");
+
+    printf("\n---------- Begin Buddy Test ----------\n");
+    buddyThreadTest();
+    threadCacheTest("Buddy");
+    printf("\n---------- End Buddy Test ----------\n");
+
+    printf("\n---------- Begin Compact Test ----------\n");
+    compactTest();
+    printf("\n---------- End Compact Test ----------\n");
+
+    printf("\n---------- Begin Thread Cache Test ----------\n");
+    threadCacheTest("FirstFit");
+    threadCacheTest("NextFit");
+    printf("\n---------- End Thread Cache Test ----------\n");
+
+    printf("\n---------- Begin Aligned Allocation Test ----------\n");
+    alignedThreadTest("FirstFit");
+    alignedThreadTest("BestFit");
+    alignedThreadTest("WorstFit");
+    alignedThreadTest("NextFit");
+    alignedThreadTest("SegregatedFit");
+    alignedThreadTest("TLSF");
+    alignedThreadTest("Compact");
+    alignedThreadTest("Buddy");
+    printf("\n---------- End Aligned Allocation Test ----------\n");
+
+    printf("\n---------- Begin Reallocate Test ----------\n");
+    reallocateTest("FirstFit");
+    reallocateTest("BestFit");
+    reallocateTest("TLSF");
+    reallocateTest("Compact");
+    buddyReallocateTest();
+    printf("\n---------- End Reallocate Test ----------\n");
+
+    printf("\n---------- Begin Callocate Test ----------\n");
+    callocateTest("FirstFit");
+    callocateTest("SegregatedFit");
+    callocateTest("BestFit");
+    callocateTest("Buddy");
+    printf("\n---------- End Callocate Test ----------\n");
+
+    printf("\n---------- Begin Batch Test ----------\n");
+    batchTest("FirstFit");
+    batchTest("NextFit");
+    batchTest("SegregatedFit");
+    batchTest("WorstFit");
+    batchTest("Compact");
+    printf("\n---------- End Batch Test ----------\n");
+
+    printf("\n---------- Begin Growable Heap Test ----------\n");
+    growableTest("FirstFit");
+    growableTest("BestFit");
+    growableTest("SegregatedFit");
+    printf("\n---------- End Growable Heap Test ----------\n");
+
+    printf("\n---------- Begin Trim Test ----------\n");
+    trimTest("FirstFit");
+    trimTest("SegregatedFit");
+    trimTest("Buddy");
+    printf("\n---------- End Trim Test ----------\n");
+
+    printf("\n---------- Begin Mapped Heap Test ----------\n");
+    mappedHeapTest();
+    printf("\n---------- End Mapped Heap Test ----------\n");
+
+    printf("\n---------- Begin Map Threshold Test ----------\n");
+    mapThresholdTest("FirstFit");
+    mapThresholdTest("TLSF");
+    mapThresholdTest("Buddy");
+    printf("\n---------- End Map Threshold Test ----------\n");
+
+    printf("\n---------- Begin Deferred Coalescing Test ----------\n");
+    deferredTest("FirstFit");
+    deferredTest("TLSF");
+    deferredTest("Compact");
+    printf("\n---------- End Deferred Coalescing Test ----------\n");
+
+    printf("\n---------- Begin Lock Policy Test ----------\n");
+    lockPolicyTest("None");
+    lockPolicyTest("Spin");
+    lockPolicyTest("Ticket");
+    lockPolicyTest("Futex");
+    printf("\n---------- End Lock Policy Test ----------\n");
+
+    printf("\n---------- Begin Flat Combining Test ----------\n");
+    combiningTest("FirstFit");
+    combiningTest("TLSF");
+    combiningTest("Buddy");
+    printf("\n---------- End Flat Combining Test ----------\n");
+
+    printf("\n---------- Begin Lock-Free Size Class Test ----------\n");
+    lockFreeClassTest("FirstFit");
+    lockFreeClassTest("TLSF");
+    lockFreeClassTest("Buddy");
+    printf("\n---------- End Lock-Free Size Class Test ----------\n");
+
+    printf("\n---------- Begin Remote Free Test ----------\n");
+    remoteFreeTest("FirstFit");
+    remoteFreeTest("TLSF");
+    remoteFreeTest("Buddy");
+    printf("\n---------- End Remote Free Test ----------\n");
+
+    printf("\n---------- Begin Region Locking Test ----------\n");
+    regionLockingTest("FirstFit");
+    regionLockingTest("NextFit");
+    printf("\n---------- End Region Locking Test ----------\n");
+
+    printf("\n---------- Begin Arena Test ----------\n");
+    arenaTest("FirstFit");
+    arenaTest("BestFit");
+    arenaTest("TLSF");
+    arenaTest("Buddy");
+    printf("\n---------- End Arena Test ----------\n");
+
+    printf("\n---------- Begin Heap Handle Test ----------\n");
+    heapHandleTest();
+    printf("\n---------- End Heap Handle Test ----------\n");
+
+    printf("\n---------- Begin Pool Test ----------\n");
+    poolTest();
+    printf("\n---------- End Pool Test ----------\n");
+
+    printf("\n---------- Begin Small Block Test ----------\n");
+    smallBlockTest();
+    printf("\n---------- End Small Block Test ----------\n");
 
     printf("\n---------- Testing Ends ----------");
 }